@@ -9,6 +9,7 @@
 #include <functional>
 
 #include "mico/tokens.h"
+#include "mico/node_pool.h"
 
 #ifdef __clang__
 #   pragma clang diagnostic ignored "-Wswitch"
@@ -48,6 +49,7 @@ namespace mico { namespace ast {
         INFIN           = 26,
         MOD_MUT         = 27,
         MOD_CONST       = 28,
+        LAZY            = 29,
 
 #if !defined(DISABLE_MACRO) || !DISABLE_MACRO
         QUOTE           = 50,
@@ -89,6 +91,7 @@ namespace mico { namespace ast {
             case type::BREAK        : return "BREAK";
             case type::CONTINUE     : return "CONTINUE";
             case type::INFIN        : return "INF";
+            case type::LAZY         : return "LAZY";
 
 #if !defined(DISABLE_MACRO) || !DISABLE_MACRO
             case type::QUOTE        : return "QUOTE";
@@ -101,6 +104,18 @@ namespace mico { namespace ast {
         }
     };
 
+    /// operands that an infix or a prefix node has seen.
+    /// A node starts UNKNOWN, takes the kind of its first operands and
+    /// becomes GENERIC for good when they change.
+    enum class quick {
+        UNKNOWN = 0,
+        INTEGER,
+        FLOAT,
+        STRING,
+        BOOLEAN,
+        GENERIC,
+    };
+
     struct node {
 
         virtual ~node( ) = default;
@@ -115,6 +130,18 @@ namespace mico { namespace ast {
         virtual uptr clone( ) const = 0;
         virtual bool is_const( ) const = 0;
 
+        static
+        void *operator new( std::size_t size )
+        {
+            return node_pool::alloc( size );
+        }
+
+        static
+        void operator delete( void *ptr, std::size_t size )
+        {
+            node_pool::free( ptr, size );
+        }
+
         template <typename ArtT, typename ...Args>
         static
         typename ArtT::uptr make( Args && ... args )
@@ -158,10 +185,25 @@ namespace mico { namespace ast {
             return false;
         }
 
+        /// a copy that keeps the position of the original
+        static
+        uptr call_clone( const node *target )
+        {
+            auto res = target->clone( );
+            res->set_pos( target->pos( ) );
+            return res;
+        }
+
         static
         uptr call_clone( const uptr &target )
         {
-            return target->clone( );
+            return call_clone( target.get( ) );
+        }
+
+        static
+        uptr call_clone( const sptr &target )
+        {
+            return call_clone( target.get( ) );
         }
 
     private:
@@ -215,7 +257,7 @@ namespace mico { namespace ast {
         static
         uptr call_clone( const uptr &target )
         {
-            auto res = target->clone( );
+            auto res = node::call_clone( target.get( ) );
             return cast( res );
         }
 
@@ -260,7 +302,7 @@ namespace mico { namespace ast {
         static
         uptr call_clone( const uptr &target )
         {
-            auto res = target->clone( );
+            auto res = node::call_clone( target.get( ) );
             return cast( res );
         }
 
@@ -51,19 +51,19 @@ namespace mico { namespace builtin {
         static
         objects::sptr make_mut( environment::sptr e, call_type c )
         {
-            return std::make_shared<common>( e, std::move(c) );
+            return mico::make_shared<common>( e, std::move(c) );
         }
 
         static
         objects::sptr make_mut( environment::sptr e, init_type i, call_type c )
         {
-            return std::make_shared<common>( e, std::move(i), std::move(c) );
+            return mico::make_shared<common>( e, std::move(i), std::move(c) );
         }
 
         static
         objects::sptr make( environment::sptr e, call_type c )
         {
-            auto res = std::make_shared<common>( e, std::move(c) );
+            auto res = mico::make_shared<common>( e, std::move(c) );
             res->set_mutable( true );
             return res;
         }
@@ -71,7 +71,7 @@ namespace mico { namespace builtin {
         static
         objects::sptr make( environment::sptr e, init_type i, call_type c )
         {
-            auto res = std::make_shared<common>( e, std::move(i),
+            auto res = mico::make_shared<common>( e, std::move(i),
                                                  std::move(c) );
             res->set_mutable( true );
             return res;
@@ -79,7 +79,7 @@ namespace mico { namespace builtin {
 
         objects::sptr clone( ) const override
         {
-            return std::make_shared<common>( env( ), init_, call_ );
+            return mico::make_shared<common>( env( ), init_, call_ );
         }
 
     private:
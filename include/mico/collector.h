@@ -0,0 +1,125 @@
+#ifndef MICO_COLLECTOR_H
+#define MICO_COLLECTOR_H
+
+#include <vector>
+#include <unordered_set>
+
+#include "mico/environment.h"
+#include "mico/objects/base.h"
+
+namespace mico {
+
+    /// Mark and sweep over the environment tree.
+    /// The mark counters keep an environment while somebody refers to it,
+    /// but two environments that hold each other's closures stay marked
+    /// after both become garbage. The collector traces what is reachable
+    /// from the top environment, from the roots that the caller adds and
+    /// from every environment that the evaluator holds (it is owned by
+    /// something else than its parent). The rest is removed from the tree.
+    class collector {
+
+    public:
+
+        struct result {
+            std::size_t envs  = 0;
+            std::size_t bytes = 0;
+        };
+
+        void add_root( const environment *e )
+        {
+            while( e && envs_.insert( e ).second ) {
+                env_queue_.push_back( e );
+                e = e->parent( ).get( );
+            }
+        }
+
+        void add_root( const objects::base *o )
+        {
+            if( o && objs_.insert( o ).second ) {
+                obj_queue_.push_back( o );
+            }
+        }
+
+        result run( environment::sptr top )
+        {
+            result res;
+            add_root( top.get( ) );
+            find_roots( top.get( ) );
+            mark( );
+            sweep( top.get( ), res );
+            return res;
+        }
+
+    private:
+
+        void find_roots( environment *e )
+        {
+            for( auto &c: e->children( ) ) {
+                if( c.use_count( ) > 1 ) {
+                    add_root( c.get( ) );
+                }
+                find_roots( c.get( ) );
+            }
+        }
+
+        void mark( )
+        {
+            std::vector<const objects::base *> next;
+            while( !env_queue_.empty( ) || !obj_queue_.empty( ) ) {
+                if( !env_queue_.empty( ) ) {
+                    auto e = env_queue_.back( );
+                    env_queue_.pop_back( );
+                    e->each_value( [this]( const objects::base *o ) {
+                        add_root( o );
+                    } );
+                    for( auto &p: e->parents( ) ) {
+                        add_root( p.lock( ).get( ) );
+                    }
+                } else {
+                    auto o = obj_queue_.back( );
+                    obj_queue_.pop_back( );
+                    add_root( o->hold( ) );
+                    next.clear( );
+                    o->trace( next );
+                    for( auto n: next ) {
+                        add_root( n );
+                    }
+                }
+            }
+        }
+
+        static
+        std::size_t count( const environment *e )
+        {
+            std::size_t res = 1;
+            for( auto &c: e->children( ) ) {
+                res += count( c.get( ) );
+            }
+            return res;
+        }
+
+        void sweep( environment *e, result &res )
+        {
+            auto &chld( e->children( ) );
+            auto b = chld.begin( );
+            while( b != chld.end( ) ) {
+                if( envs_.count( b->get( ) ) ) {
+                    sweep( b->get( ), res );
+                    ++b;
+                } else {
+                    res.envs  += count( b->get( ) );
+                    res.bytes += (*b)->footprint( );
+                    b = chld.erase( b );
+                }
+            }
+        }
+
+        std::unordered_set<const environment *>   envs_;
+        std::unordered_set<const objects::base *> objs_;
+        std::vector<const environment *>         env_queue_;
+        std::vector<const objects::base *>       obj_queue_;
+    };
+
+}
+
+#endif // MICO_COLLECTOR_H
@@ -3,13 +3,16 @@
 
 #include <set>
 #include <map>
+#include <array>
 #include <list>
 #include <vector>
 #include <iostream>
 #include <memory>
 
+#include "mico/shared.h"
 #include "mico/objects/base.h"
 #include "mico/objects/reference.h"
+#include "mico/layout.h"
 
 #include "etool/console/colors.h"
 
@@ -24,14 +27,14 @@ namespace mico {
 
     struct state;
 
-    class environment: public std::enable_shared_from_this<environment> {
+    class environment: public mico::enable_shared_from_this<environment> {
 
     public:
 
-        using sptr          = std::shared_ptr<environment>;
-        using wptr          = std::weak_ptr<environment>;
-        using object_sptr   = std::shared_ptr<objects::base>;
-        using object_wptr   = std::weak_ptr<objects::base>;
+        using sptr          = mico::shared_ptr<environment>;
+        using wptr          = mico::weak_ptr<environment>;
+        using object_sptr   = mico::shared_ptr<objects::base>;
+        using object_wptr   = mico::weak_ptr<objects::base>;
         using children_type = std::set<sptr>;
         using obj_reference = objects::impl<objects::type::REFERENCE>;
         using data_map      = std::map<std::string, obj_reference::sptr>;
@@ -42,6 +45,19 @@ namespace mico {
 
         struct key { };
 
+        /// a binding of the layout. The value is kept unboxed; the
+        /// reference is made only when somebody asks for it.
+        struct binding {
+            object_sptr          value;
+            obj_reference::sptr  ref;
+            bool                 var = false;
+        };
+
+        using slot_list = std::vector<binding>;
+
+        /// the typical function has a couple of parameters and lets
+        static const std::size_t inline_slots = 4;
+
     public:
 
         struct scoped {
@@ -73,16 +89,28 @@ namespace mico {
 
         environment( state *st, key )
             :state_(st)
+            ,root_(this)
         {
 #if DEBUG
             std::cout << ++c << "\n";
 #endif
         }
 
-        environment( sptr env, key )
+        environment( sptr env, layout::sptr lay, key )
             :state_(env->state_)
+            ,root_(env->root_)
             ,parent_(env)
+            ,layout_(std::move(lay))
         {
+            if( layout_ ) {
+                slot_count_ = layout_->size( );
+                if( slot_count_ > inline_slots ) {
+                    extra_.resize( slot_count_ );
+                    slots_ = extra_.data( );
+                } else {
+                    slots_ = inline_.data( );
+                }
+            }
 #if DEBUG
             std::cout << ++c << "\n";
 #endif
@@ -93,7 +121,20 @@ namespace mico {
 #if DEBUG
             std::cout << --c << "\n";
 #endif
+            /// references can outlive us; they must not see this
+            for( auto &d: data_ ) {
+                d.second->detach( );
+            }
+            for( auto &h: hide_ ) {
+                h->detach( );
+            }
+            for( std::size_t i = 0; i < slot_count_; ++i ) {
+                if( slots_[i].ref ) {
+                    slots_[i].ref->detach( );
+                }
+            }
             data_.clear( );
+            release_slots( );
             children_.clear( );
         }
 
@@ -101,23 +142,55 @@ namespace mico {
         {
             if( children_.empty( ) ) {
                 data_.clear( );
+                release_slots( );
             }
         }
 
         static
         sptr make( state *st )
         {
-            return std::make_shared<environment>( st, key( ) );
+            return mico::make_shared<environment>( st, key( ) );
         }
 
         static
-        sptr make( sptr parent )
+        sptr make( sptr parent, layout::sptr lay = layout::sptr( ) )
         {
-            auto res = std::make_shared<environment>( parent, key( ) );
+            auto res = mico::make_shared<environment>( parent, std::move(lay),
+                                                      key( ) );
             parent->children_.insert(res);
+            parent->root_->young_.push_back(res);
             return res;
         }
 
+        /// empties 'env' for one more run of its scope, the next step of
+        /// a loop. Only an environment that a collection could drop is
+        /// taken: held by its parent and the caller only, not marked and
+        /// with no reference to its bindings outside
+        static
+        bool recycle( const sptr &env )
+        {
+            auto p = env->parent( );
+            if( !p || env.use_count( ) != 2 || env->marked_
+             || env->owner_ || !env->children_.empty( )
+             || !env->hide_.empty( ) || !env->parents_.empty( )
+             || p->children_.find( env ) == p->children_.end( ) ) {
+                return false;
+            }
+            for( auto &d: env->data_ ) {
+                if( d.second.use_count( ) > 1 ) {
+                    return false;
+                }
+            }
+            for( std::size_t i = 0; i < env->slot_count_; ++i ) {
+                if( env->slots_[i].ref.use_count( ) > 1 ) {
+                    return false;
+                }
+            }
+            env->data_.clear( );
+            env->release_slots( );
+            return true;
+        }
+
         static
         bool mark_in( environment::sptr remote, const environment *current )
         {
@@ -189,6 +262,7 @@ namespace mico {
                 auto p = parent( );
                 if( p ) {
                     data_.clear( );
+                    release_slots( );
                     p->drop( shared_from_this( ) );
                 }
             }
@@ -284,7 +358,8 @@ namespace mico {
             sptr parent = shared_from_this( );
             while( cur ) {
                 auto f = cur->data_.find( name );
-                if( f != cur->data_.end( ) ) {
+                auto slot = cur->find_slot( name );
+                if( f != cur->data_.end( ) || ( slot && bound( *slot ) ) ) {
                     return parent;
                 } else {
                     parent = cur->parent( );
@@ -301,14 +376,23 @@ namespace mico {
 
         void set( const std::string &name, object_sptr val )
         {
-            auto ref = obj_reference::make_var( this, val );
-            data_[name] = ref;
+            bind( name, std::move(val), true );
         }
 
         void set_const( const std::string &name, object_sptr val )
         {
-            auto ref = obj_reference::make_const( this, val );
-            data_[name] = ref;
+            bind( name, std::move(val), false );
+        }
+
+        /// binds slot 'slot' of 'owner'; false if the layout is not ours
+        bool set( std::size_t slot, const layout *owner,
+                  object_sptr val, bool var )
+        {
+            if( layout_.get( ) != owner ) {
+                return false;
+            }
+            store( slots_[slot], std::move(val), var );
+            return true;
         }
 
         void keep( object_sptr val )
@@ -318,13 +402,7 @@ namespace mico {
 
         object_sptr get_here( const std::string &name )
         {
-            auto f = data_.find( name );
-            if( f != data_.end( ) ) {
-                return f->second->is_mutable( )
-                     ? f->second
-                     : f->second->value( );
-            }
-            return nullptr;
+            return lookup_here( name, true );
         }
 
         object_sptr get_parent( const std::string &name, bool here_only )
@@ -357,22 +435,32 @@ namespace mico {
             return get_parent( name, true );
         }
 
+        /// a mutable binding is returned as a reference to it
         object_sptr get( const std::string &name )
         {
-            auto cur = this;
-            object_sptr res;
-            sptr parent;
-            while( cur && !res ) {
-                if( auto val = cur->get_here( name ) ) {
-                    res = val;
-                } else if( auto pr = cur->get_parent( name, false ) ) {
-                    res = pr;
-                } else {
-                    parent = cur->parent( );
-                    cur = parent.get( );
-                }
-            }
-            return res;
+            return lookup( name, true );
+        }
+
+        /// the same as 'get' but never returns a reference
+        object_sptr get_value( const std::string &name )
+        {
+            return lookup( name, false );
+        }
+
+        /// the resolver's coordinates; nullptr if the slot is not ours
+        /// or it is not bound yet. The caller falls back to 'get(name)'
+        object_sptr get( std::size_t depth, std::size_t slot,
+                         const layout *owner )
+        {
+            auto b = find_slot( depth, slot, owner );
+            return b ? load_ref( *b ) : nullptr;
+        }
+
+        object_sptr get_value( std::size_t depth, std::size_t slot,
+                               const layout *owner )
+        {
+            auto b = find_slot( depth, slot, owner );
+            return b ? load( *b ) : nullptr;
         }
 
         data_map &data( )
@@ -380,11 +468,21 @@ namespace mico {
             return data_;
         }
 
+        const layout::sptr &get_layout( ) const
+        {
+            return layout_;
+        }
+
         children_type &children( )
         {
             return children_;
         }
 
+        const children_type &children( ) const
+        {
+            return children_;
+        }
+
         void introspect( )
         {
             std::cout << "Root: ";
@@ -398,6 +496,16 @@ namespace mico {
             std::string space( level * 2, ' ' );
             std::cout << "[" << (marked( ) ? cyan : light)
                       << this << none << "]\n" ;
+            for( std::size_t i = 0; i < slot_count_; ++i ) {
+                if( !bound( slots_[i] ) ) {
+                    continue;
+                }
+                char mut = slots_[i].var ?'M' : 'C';
+                std::cout << space << mut << " #" << i << " "
+                          << layout_->names( )[i]
+                          << " => " << load( slots_[i] )
+                          << std::endl;
+            }
             for( auto &d: data_ ) {
                 char mut = d.second->is_mutable( ) ?'M' : 'C';
                 std::cout << space << mut << " " << d.first
@@ -432,13 +540,78 @@ namespace mico {
             }
         }
 
+        /// environments that were made after the last minor collection
+        std::size_t young_size( ) const
+        {
+            return root_->young_.size( );
+        }
+
+        /// drops the young environments that are not marked and not held
+        /// by the evaluator. Marked ones go to the old generation that is
+        /// scanned only by 'run_GC'
+        void collect_young( )
+        {
+            std::vector<wptr> young;
+            young.swap( root_->young_ );
+            for( auto &w: young ) {
+                auto e = w.lock( );
+                if( !e || e->marked( ) ) {
+                    continue;
+                }
+                auto p = e->parent( );
+                if( !p ) {
+                    continue;
+                }
+                if( e.use_count( ) > 2 ) {
+                    root_->young_.push_back( e );
+                } else {
+                    p->children_.erase( e );
+                }
+            }
+        }
+
+        /// values that are bound here, for the cycle collector
+        template <typename CallT>
+        void each_value( CallT call ) const
+        {
+            for( std::size_t i = 0; i < slot_count_; ++i ) {
+                if( bound( slots_[i] ) ) {
+                    call( load( slots_[i] ).get( ) );
+                }
+            }
+            for( auto &d: data_ ) {
+                call( d.second->value( ).get( ) );
+            }
+            for( auto &h: hide_ ) {
+                call( h->value( ).get( ) );
+            }
+        }
+
+        /// approximate size of this environment and its subtree
+        std::size_t footprint( ) const
+        {
+            const std::size_t node = 4 * sizeof(void *);
+            const std::size_t ref  = sizeof(obj_reference) + node;
+            std::size_t res = sizeof(environment)
+                            + extra_.capacity( ) * sizeof(binding)
+                            + data_.size( ) * ( sizeof(data_map::value_type)
+                                              + node + ref )
+                            + hide_.size( ) * ( node + ref );
+            for( auto &c: children_ ) {
+                res += c->footprint( ) + node;
+            }
+            return res;
+        }
+
+        /// drops the children that are neither marked nor held by the
+        /// evaluator, the same test as 'collect_young'
         void run_GC( bool deep )
         {
             auto b = children( ).begin( );
             auto e = children( ).end( );
             while( b != e ) {
                 auto lck = (*b)->marked( );
-                if( 0 == lck ) {
+                if( 0 == lck && b->use_count( ) < 2 ) {
                     b = children( ).erase( b );
                 } else {
                     if( deep ) {
@@ -452,17 +625,157 @@ namespace mico {
 
     private:
 
+        binding *find_slot( const std::string &name )
+        {
+            if( layout_ ) {
+                auto id = layout_->find( name );
+                if( id != layout::npos ) {
+                    return &slots_[id];
+                }
+            }
+            return nullptr;
+        }
+
+        binding *find_slot( std::size_t depth, std::size_t slot,
+                            const layout *owner )
+        {
+            auto cur = this;
+            for( ; cur && depth > 0; --depth ) {
+                cur = cur->parent_.lock( ).get( );
+            }
+            if( cur && cur->layout_.get( ) == owner ) {
+                return &cur->slots_[slot];
+            }
+            return nullptr;
+        }
+
+        void bind( const std::string &name, object_sptr val, bool var )
+        {
+            if( auto slot = find_slot( name ) ) {
+                store( *slot, std::move(val), var );
+            } else if( var ) {
+                data_[name] = obj_reference::make_var( this, val );
+            } else {
+                data_[name] = obj_reference::make_const( this, val );
+            }
+        }
+
+        static
+        bool bound( const binding &b )
+        {
+            return b.value || b.ref;
+        }
+
+        /// an unboxed value holds its lock in this environment
+        /// the same way the reference does
+        void store( binding &b, object_sptr val, bool var )
+        {
+            val->mark_in( this );
+            release( b );
+            b.value = std::move(val);
+            b.var   = var;
+        }
+
+        void release( binding &b )
+        {
+            if( b.value ) {
+                b.value->unmark_in( this );
+                b.value.reset( );
+            }
+            b.ref.reset( );
+        }
+
+        void release_slots( )
+        {
+            for( std::size_t i = 0; i < slot_count_; ++i ) {
+                release( slots_[i] );
+            }
+        }
+
+        static
+        object_sptr load( const binding &b )
+        {
+            return b.ref ? b.ref->value( ) : b.value;
+        }
+
+        /// boxes a mutable value; the reference takes over the lock
+        object_sptr load_ref( binding &b )
+        {
+            if( b.ref ) {
+                return b.ref;
+            }
+            if( !b.value || !b.var ) {
+                return b.value;
+            }
+            auto ref = obj_reference::make_var( this, b.value );
+            release( b );
+            b.ref = ref;
+            return ref;
+        }
+
+        object_sptr lookup_here( const std::string &name, bool ref )
+        {
+            if( auto slot = find_slot( name ) ) {
+                return ref ? load_ref( *slot ) : load( *slot );
+            }
+            auto f = data_.find( name );
+            if( f != data_.end( ) ) {
+                return ( ref && f->second->is_mutable( ) )
+                     ? f->second
+                     : f->second->value( );
+            }
+            return nullptr;
+        }
+
+        object_sptr lookup( const std::string &name, bool ref )
+        {
+            auto cur = this;
+            object_sptr res;
+            sptr parent;
+            while( cur && !res ) {
+                if( auto val = cur->lookup_here( name, ref ) ) {
+                    res = val;
+                } else if( auto pr = cur->get_parent( name, false ) ) {
+                    res = ref ? pr : obj_reference::unref( pr );
+                } else {
+                    parent = cur->parent( );
+                    cur = parent.get( );
+                }
+            }
+            return res;
+        }
+
         state                *state_;
+        environment          *root_;
+        std::vector<wptr>     young_;
         wptr                  parent_;
         children_type         children_;
         data_map              data_;
         data_set              hide_;
+        layout::sptr          layout_;
+        std::array<binding, inline_slots> inline_;
+        slot_list             extra_;
+        binding              *slots_ = nullptr;
+        std::size_t           slot_count_ = 0;
         parent_list           parents_;
         std::size_t           marked_ = 0;
         const objects::base  *owner_ = nullptr;
     };
 }
 
+namespace mico { namespace objects {
+
+    inline
+    mico::weak_ptr<environment> reference::guard_of( const environment *e )
+    {
+        if( e ) {
+            return const_cast<environment *>( e )->shared_from_this( );
+        }
+        return mico::weak_ptr<environment>( );
+    }
+
+}}
+
 #ifdef CHECK_ENV_PARENTS
 #   undef CHECK_ENV_PARENTS
 #endif
@@ -0,0 +1,672 @@
+#ifndef MICO_EVAL_BYTECODE_H
+#define MICO_EVAL_BYTECODE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+#include "mico/ast.h"
+#include "mico/expressions.h"
+#include "mico/statements.h"
+#include "mico/tokens.h"
+
+namespace mico { namespace eval { namespace bytecode {
+
+    enum class opcode: std::uint8_t {
+        NOP,
+        PUSH_NULL,
+        PUSH_LITERAL,       /// node: integer, float, string, char, bool, inf
+        LOAD,               /// node: ident
+        LOAD_REF,           /// node: ident; the left side of ASSIGN
+        REGISTRY,
+        POP,
+        UNREF,
+        LET,                /// a: is mutable
+        MUT,
+        CONST,
+        PREFIX,
+        INFIX_LEFT,         /// a: end
+        INFIX_RIGHT,
+        DOT,                /// a: end, b: common infix
+        ASSIGN_LEFT,        /// a: end
+        ASSIGN,
+        IF_COND,            /// a: next branch, b: end, c: unless
+        ENV_PUSH,
+        ENV_POP,
+        SCOPE_ENTER,        /// a: end of the scope
+        SCOPE_LEAVE,
+        STMT_CHECK,         /// a: scope leave
+        PROG_STMT,          /// a: end of the program
+        PROG_LAST,
+        FOR_FIRST,          /// a: end, b: init
+        FOR_SECOND,         /// a: end
+        FOR_INIT,           /// a: end
+        FOR_ITER,           /// a: exit
+        FOR_STEP,           /// a: exit, b: end
+        FOR_NEXT,           /// a: top of the loop
+        FOR_EXIT,
+        BREAK_OBJ,
+        CONT_OBJ,
+        UNWIND,             /// a: environments, b: scopes
+        JUMP,               /// a: target
+        RET,
+        RET_OBJ,
+        CALL_BEGIN,         /// a: past the call, b: args count, c: flags
+        CALL_ARG,           /// a: call end, b: past the call, c: arg index
+        CALL_END,           /// always the last one in the call sequence
+        TAIL_END,
+        MAKE_FUNCTION,      /// a: proto
+        FN_INIT,            /// a: name, b: end
+        ARRAY_NEW,
+        ARRAY_PUSH,         /// a: end
+        TABLE_NEW,
+        TABLE_KEY,          /// a: end
+        TABLE_SET,          /// a: end
+        INDEX_VALUE,        /// a: end
+        INDEX,
+        RUN_CHUNK,          /// a: child
+        FALLBACK,
+        END,
+    };
+
+    struct instruction {
+        opcode        op;
+        std::int32_t  a;
+        std::int32_t  b;
+        std::int32_t  c;
+        ast::node    *node;
+    };
+
+    struct function_proto {
+        using params_ptr = std::shared_ptr<ast::expressions::list>;
+        params_ptr      params;
+        ast::node::sptr body;
+        std::size_t     init_size;
+    };
+
+    struct chunk {
+
+        using sptr = std::shared_ptr<chunk>;
+        using code_type = std::vector<instruction>;
+
+        enum class kind {
+            PROGRAM,
+            FUNCTION,
+            EXPRESSION,
+        };
+
+        explicit
+        chunk( kind k )
+            :type(k)
+        { }
+
+        kind                        type;
+        code_type                   code;
+        std::vector<std::string>    names;
+        std::vector<function_proto> protos;
+        std::vector<sptr>           children;
+    };
+
+    enum call_flags {
+        CALL_COUNTED = 0x01,
+    };
+
+    class compiler {
+
+        struct loop_info {
+            std::size_t         envs;
+            std::size_t         scopes;
+            std::vector<std::size_t> breaks;
+            std::vector<std::size_t> conts;
+        };
+
+        explicit
+        compiler( chunk::kind k )
+            :chunk_(std::make_shared<chunk>( k ))
+        { }
+
+        std::size_t here( ) const
+        {
+            return chunk_->code.size( );
+        }
+
+        std::size_t emit( opcode op, ast::node *n = nullptr,
+                          std::int32_t a = 0, std::int32_t b = 0,
+                          std::int32_t c = 0 )
+        {
+            chunk_->code.push_back( instruction { op, a, b, c, n } );
+            return here( ) - 1;
+        }
+
+        void patch_a( std::size_t pos, std::size_t target )
+        {
+            chunk_->code[pos].a = static_cast<std::int32_t>(target);
+        }
+
+        void patch_b( std::size_t pos, std::size_t target )
+        {
+            chunk_->code[pos].b = static_cast<std::int32_t>(target);
+        }
+
+        std::int32_t add_name( const std::string &name )
+        {
+            chunk_->names.push_back( name );
+            return static_cast<std::int32_t>(chunk_->names.size( ) - 1);
+        }
+
+        static
+        bool is_call( const ast::node *n )
+        {
+            return n->get_type( ) == ast::type::CALL;
+        }
+
+        /// 'direct' means that the node is evaluated as a statement,
+        ///  so it is safe to leave the frame or the loop from here.
+        struct context {
+            bool frame_direct;
+            bool loop_direct;
+            bool tail;
+        };
+
+        static
+        context expression_ctx( )
+        {
+            return context { false, false, false };
+        }
+
+        void compile_node( ast::node *n, context ctx )
+        {
+            switch( n->get_type( ) ) {
+            case ast::type::PROGRAM:
+                compile_nested_program( n );
+                break;
+            case ast::type::EXPR: {
+                auto expr = ast::cast<ast::statements::expr>( n );
+                compile_node( expr->value( ).get( ), ctx );
+                break;
+            }
+            case ast::type::BOOLEAN:
+            case ast::type::INTEGER:
+            case ast::type::FLOAT:
+            case ast::type::STRING:
+            case ast::type::CHARACTER:
+            case ast::type::INFIN:
+                emit( opcode::PUSH_LITERAL, n );
+                break;
+            case ast::type::IDENT:
+                emit( opcode::LOAD, n );
+                break;
+            case ast::type::REGISTRY:
+                emit( opcode::REGISTRY, n );
+                break;
+            case ast::type::ARRAY:
+                compile_array( n );
+                break;
+            case ast::type::TABLE:
+                compile_table( n );
+                break;
+            case ast::type::PREFIX: {
+                auto pref = ast::cast<ast::expressions::prefix>( n );
+                compile_node( pref->value( ).get( ), expression_ctx( ) );
+                emit( opcode::PREFIX, n );
+                break;
+            }
+            case ast::type::INFIX:
+                compile_infix( n );
+                break;
+            case ast::type::IFELSE:
+                compile_ifelse( n, ctx );
+                break;
+            case ast::type::FORIN:
+                compile_forin( n, ctx );
+                break;
+            case ast::type::INDEX:
+                compile_index( n );
+                break;
+            case ast::type::LET:
+                compile_let( n );
+                break;
+            case ast::type::RETURN:
+                compile_return( n, ctx );
+                break;
+            case ast::type::MOD_MUT: {
+                auto mm = ast::cast<ast::expressions::mod_mut>( n );
+                compile_node( mm->value( ).get( ), expression_ctx( ) );
+                emit( opcode::MUT, n );
+                break;
+            }
+            case ast::type::MOD_CONST: {
+                auto mm = ast::cast<ast::expressions::mod_const>( n );
+                compile_node( mm->value( ).get( ), expression_ctx( ) );
+                emit( opcode::CONST, n );
+                break;
+            }
+            case ast::type::BREAK:
+                compile_break_cont( n, ctx, true );
+                break;
+            case ast::type::CONTINUE:
+                compile_break_cont( n, ctx, false );
+                break;
+            case ast::type::FN:
+                compile_function( n );
+                break;
+            case ast::type::CALL:
+                compile_call( n, ctx.tail );
+                break;
+            case ast::type::LIST:
+                compile_scope( n, ctx );
+                break;
+            case ast::type::LAZY: {
+                auto lz = ast::cast<ast::expressions::lazy>( n );
+                if( lz->errors( ).empty( ) ) {
+                    compile_node( lz->get( ).get( ), ctx );
+                } else {
+                    emit( opcode::FALLBACK, n );
+                }
+                break;
+            }
+            case ast::type::MODULE:
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+            case ast::type::QUOTE:
+            case ast::type::UNQUOTE:
+#endif
+                emit( opcode::FALLBACK, n );
+                break;
+            default:
+                emit( opcode::PUSH_NULL, n );
+                break;
+            }
+        }
+
+        void compile_nested_program( ast::node *n )
+        {
+            chunk_->children.push_back( compile_program( n ) );
+            emit( opcode::RUN_CHUNK, n,
+                  static_cast<std::int32_t>(chunk_->children.size( ) - 1) );
+        }
+
+        void compile_array( ast::node *n )
+        {
+            auto arr = ast::cast<ast::expressions::array>( n );
+            emit( opcode::ARRAY_NEW, n );
+            std::vector<std::size_t> fails;
+            for( auto &a: arr->value( ) ) {
+                compile_node( a.get( ), expression_ctx( ) );
+                fails.push_back( emit( opcode::ARRAY_PUSH, a.get( ) ) );
+            }
+            for( auto f: fails ) {
+                patch_a( f, here( ) );
+            }
+        }
+
+        void compile_table( ast::node *n )
+        {
+            auto table = ast::cast<ast::expressions::table>( n );
+            emit( opcode::TABLE_NEW, n );
+            std::vector<std::size_t> fails;
+            for( auto &v: table->value( ) ) {
+                compile_node( v.first.get( ), expression_ctx( ) );
+                fails.push_back( emit( opcode::TABLE_KEY, v.first.get( ) ) );
+                compile_node( v.second.get( ), expression_ctx( ) );
+                fails.push_back( emit( opcode::TABLE_SET, v.second.get( ) ) );
+            }
+            for( auto f: fails ) {
+                patch_a( f, here( ) );
+            }
+        }
+
+        void compile_infix( ast::node *n )
+        {
+            auto inf = ast::cast<ast::expressions::infix>( n );
+
+            if( inf->token( ) == tokens::type::ASSIGN ) {
+                auto lft = inf->left( ).get( );
+                if( lft->get_type( ) == ast::type::IDENT ) {
+                    emit( opcode::LOAD_REF, lft );
+                } else {
+                    compile_node( lft, expression_ctx( ) );
+                }
+                auto left = emit( opcode::ASSIGN_LEFT, n );
+                compile_node( inf->right( ).get( ), expression_ctx( ) );
+                emit( opcode::ASSIGN, n );
+                patch_a( left, here( ) );
+                return;
+            }
+
+            compile_node( inf->left( ).get( ), expression_ctx( ) );
+
+            std::size_t dot = 0;
+            std::size_t mod_end = 0;
+            bool is_dot = ( inf->token( ) == tokens::type::DOT );
+            if( is_dot ) {
+                dot = emit( opcode::DOT, n );
+                auto right = inf->right( ).get( );
+                if( is_call( right ) ) {
+                    auto call = ast::cast<ast::expressions::call>( right );
+                    compile_call_body( call, false, 0 );
+                }
+                mod_end = emit( opcode::JUMP, n );
+                patch_b( dot, here( ) );
+            }
+
+            auto left = emit( opcode::INFIX_LEFT, n );
+            compile_node( inf->right( ).get( ), expression_ctx( ) );
+            emit( opcode::INFIX_RIGHT, n );
+            patch_a( left, here( ) );
+
+            if( is_dot ) {
+                patch_a( dot, here( ) );
+                patch_a( mod_end, here( ) );
+            }
+        }
+
+        void compile_ifelse( ast::node *n, context ctx )
+        {
+            auto ifblock = ast::cast<ast::expressions::ifelse>( n );
+            std::vector<std::size_t> ends;
+            for( auto &i: ifblock->ifs( ) ) {
+                compile_node( i.cond.get( ), expression_ctx( ) );
+                auto cond = emit( opcode::IF_COND, i.cond.get( ), 0, 0,
+                                  ifblock->is_unless( ) ? 1 : 0 );
+                ends.push_back( cond );
+                compile_branch( i.body.get( ), ctx );
+                auto jmp = emit( opcode::JUMP, n );
+                ends.push_back( jmp );
+                patch_a( cond, here( ) );
+            }
+            if( ifblock->alt( ) ) {
+                compile_branch( ifblock->alt( ).get( ), ctx );
+            } else {
+                emit( opcode::PUSH_NULL, n );
+            }
+            for( auto e: ends ) {
+                if( chunk_->code[e].op == opcode::IF_COND ) {
+                    patch_b( e, here( ) );
+                } else {
+                    patch_a( e, here( ) );
+                }
+            }
+        }
+
+        void compile_branch( ast::node *body, context ctx )
+        {
+            emit( opcode::ENV_PUSH, body );
+            envs_++;
+            compile_node( body, ctx );
+            envs_--;
+            emit( opcode::ENV_POP, body );
+            emit( opcode::UNREF, body );
+        }
+
+        void compile_forin( ast::node *n, context ctx )
+        {
+            auto fori = ast::cast<ast::expressions::forin>( n );
+            auto isize = fori->idents( )->value( ).size( );
+            auto esize = fori->expres( )->value( ).size( );
+
+            bool valid = ( isize <= 3 ) && ( esize <= 2 ) && ( esize > 0 );
+            for( auto &i: fori->idents( )->value( ) ) {
+                valid = valid && ( i->get_type( ) == ast::type::IDENT );
+            }
+
+            if( !valid ) {
+                emit( opcode::FALLBACK, n );
+                return;
+            }
+
+            auto &expres( fori->expres( )->value( ) );
+
+            compile_node( expres[0].get( ), expression_ctx( ) );
+            auto first = emit( opcode::FOR_FIRST, n );
+            std::size_t second = 0;
+            if( esize > 1 ) {
+                compile_node( expres[1].get( ), expression_ctx( ) );
+                second = emit( opcode::FOR_SECOND, n );
+            }
+            patch_b( first, here( ) );
+            auto init = emit( opcode::FOR_INIT, n,
+                              0, static_cast<std::int32_t>(esize) );
+
+            auto top = emit( opcode::FOR_ITER, n );
+
+            loops_.emplace_back( );
+            loops_.back( ).envs = envs_;
+            loops_.back( ).scopes = scopes_;
+
+            envs_++;
+            context body_ctx { ctx.frame_direct, true, false };
+            compile_node( fori->body( ).get( ), body_ctx );
+            envs_--;
+
+            auto step = emit( opcode::FOR_STEP, n );
+            auto next = emit( opcode::FOR_NEXT, n,
+                              static_cast<std::int32_t>(top) );
+            auto exit = emit( opcode::FOR_EXIT, n );
+
+            auto info = std::move(loops_.back( ));
+            loops_.pop_back( );
+
+            for( auto b: info.breaks ) {
+                patch_a( b, exit );
+            }
+            for( auto c: info.conts ) {
+                patch_a( c, next );
+            }
+
+            patch_a( top, exit );
+            patch_a( step, exit );
+            patch_b( step, here( ) );
+            patch_a( first, here( ) );
+            if( esize > 1 ) {
+                patch_a( second, here( ) );
+            }
+            patch_a( init, here( ) );
+        }
+
+        void compile_break_cont( ast::node *n, context ctx, bool brk )
+        {
+            if( ctx.loop_direct && !loops_.empty( ) ) {
+                auto &loop(loops_.back( ));
+                emit( opcode::UNWIND, n,
+                      static_cast<std::int32_t>(loop.envs),
+                      static_cast<std::int32_t>(loop.scopes) );
+                auto jmp = emit( opcode::JUMP, n );
+                if( brk ) {
+                    loop.breaks.push_back( jmp );
+                } else {
+                    loop.conts.push_back( jmp );
+                }
+            } else {
+                emit( brk ? opcode::BREAK_OBJ : opcode::CONT_OBJ, n );
+            }
+        }
+
+        void compile_index( ast::node *n )
+        {
+            auto idx = ast::cast<ast::expressions::index>( n );
+            compile_node( idx->value( ).get( ), expression_ctx( ) );
+            auto val = emit( opcode::INDEX_VALUE, n );
+            compile_node( idx->param( ).get( ), expression_ctx( ) );
+            emit( opcode::INDEX, n );
+            patch_a( val, here( ) );
+        }
+
+        void compile_let( ast::node *n )
+        {
+            auto expr = ast::cast<ast::statements::let>( n );
+            if( expr->ident( )->get_type( ) != ast::type::IDENT ) {
+                emit( opcode::FALLBACK, n );
+                return;
+            }
+            compile_node( expr->value( ).get( ), expression_ctx( ) );
+            emit( opcode::LET, n, expr->mut( ) ? 1 : 0 );
+        }
+
+        void compile_return( ast::node *n, context ctx )
+        {
+            auto expr = ast::cast<ast::statements::ret>( n );
+            auto val = expr->value( );
+            bool tail = ctx.frame_direct
+                     && ( chunk_->type == chunk::kind::FUNCTION );
+            if( tail && is_call( val ) ) {
+                compile_call( val, true );
+                return;
+            }
+            compile_node( val, expression_ctx( ) );
+            emit( ctx.frame_direct ? opcode::RET : opcode::RET_OBJ, n );
+        }
+
+        void compile_function( ast::node *n )
+        {
+            auto func = ast::cast<ast::expressions::function>( n );
+            auto init_size = func->inits( ).size( );
+            if( init_size > func->param_size( ) ) {
+                init_size = func->param_size( );
+            }
+
+            function_proto proto;
+            proto.params = func->params( );
+            proto.body   = func->body( );
+            proto.init_size = init_size;
+            chunk_->protos.emplace_back( std::move(proto) );
+
+            emit( opcode::MAKE_FUNCTION, n,
+                  static_cast<std::int32_t>(chunk_->protos.size( ) - 1) );
+
+            std::vector<std::size_t> fails;
+            for( auto &next: func->inits( ) ) {
+                compile_node( next.second.get( ), expression_ctx( ) );
+                fails.push_back( emit( opcode::FN_INIT, next.second.get( ),
+                                       add_name( next.first ) ) );
+            }
+            for( auto f: fails ) {
+                patch_b( f, here( ) );
+            }
+        }
+
+        void compile_call( ast::node *n, bool tail )
+        {
+            auto call = ast::cast<ast::expressions::call>( n );
+            compile_node( call->func( ).get( ), expression_ctx( ) );
+            compile_call_body( call, tail, tail ? 0 : CALL_COUNTED );
+        }
+
+        /// the function object is already on the stack
+        void compile_call_body( ast::expressions::call *call, bool tail,
+                                std::int32_t flags )
+        {
+            auto argc = call->param_list( ).size( );
+            auto begin = emit( opcode::CALL_BEGIN, call, 0,
+                               static_cast<std::int32_t>(argc), flags );
+            std::vector<std::size_t> args;
+            std::int32_t id = 0;
+            for( auto &p: call->param_list( ) ) {
+                compile_node( p.get( ), expression_ctx( ) );
+                args.push_back( emit( opcode::CALL_ARG, call, 0, 0, id++ ) );
+            }
+            auto end = emit( tail ? opcode::TAIL_END : opcode::CALL_END,
+                             call );
+            for( auto a: args ) {
+                patch_a( a, end );
+                patch_b( a, here( ) );
+            }
+            patch_a( begin, here( ) );
+        }
+
+        void compile_scope( ast::node *n, context ctx )
+        {
+            auto scope = ast::cast<ast::expressions::list>( n );
+            auto &lst( scope->value( ) );
+
+            auto enter = emit( opcode::SCOPE_ENTER, n );
+            scopes_++;
+
+            std::vector<std::size_t> checks;
+            if( lst.empty( ) ) {
+                emit( opcode::PUSH_NULL, n );
+            }
+            auto count = lst.size( );
+            for( auto &stmt: lst ) {
+                --count;
+                context stmt_ctx { ctx.frame_direct, ctx.loop_direct,
+                                   ctx.tail && ( 0 == count ) };
+                compile_node( stmt.get( ), stmt_ctx );
+                if( 0 != count ) {
+                    checks.push_back( emit( opcode::STMT_CHECK, n ) );
+                }
+            }
+
+            scopes_--;
+            auto leave = emit( opcode::SCOPE_LEAVE, n );
+            for( auto c: checks ) {
+                patch_a( c, leave );
+            }
+            patch_a( enter, here( ) );
+        }
+
+        chunk::sptr compile_program_impl( ast::node *n )
+        {
+            auto prog = ast::cast<ast::program>( n );
+            auto &states( prog->states( ) );
+            std::vector<std::size_t> ends;
+
+            context ctx { true, false, false };
+
+            if( states.empty( ) ) {
+                emit( opcode::PUSH_NULL, n );
+            }
+
+            auto count = states.size( );
+            for( auto &s: states ) {
+                --count;
+                compile_node( s.get( ), ctx );
+                if( 0 != count ) {
+                    ends.push_back( emit( opcode::PROG_STMT, n ) );
+                }
+            }
+            emit( opcode::PROG_LAST, n );
+            for( auto e: ends ) {
+                patch_a( e, here( ) );
+            }
+            emit( opcode::END, n );
+            return chunk_;
+        }
+
+    public:
+
+        static
+        chunk::sptr compile_program( ast::node *n )
+        {
+            compiler comp( chunk::kind::PROGRAM );
+            return comp.compile_program_impl( n );
+        }
+
+        static
+        chunk::sptr compile_function_body( ast::node *body )
+        {
+            compiler comp( chunk::kind::FUNCTION );
+            comp.compile_node( body, context { true, false, true } );
+            comp.emit( opcode::END, body );
+            return comp.chunk_;
+        }
+
+        static
+        chunk::sptr compile_expression( ast::node *n )
+        {
+            compiler comp( chunk::kind::EXPRESSION );
+            comp.compile_node( n, expression_ctx( ) );
+            comp.emit( opcode::END, n );
+            return comp.chunk_;
+        }
+
+    private:
+        chunk::sptr             chunk_;
+        std::vector<loop_info>  loops_;
+        std::size_t             envs_   = 0;
+        std::size_t             scopes_ = 0;
+    };
+
+}}}
+
+#endif // MICO_EVAL_BYTECODE_H
@@ -0,0 +1,1006 @@
+#ifndef MICO_EVAL_FOLDER_H
+#define MICO_EVAL_FOLDER_H
+
+#include <map>
+#include <set>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mico/ast.h"
+#include "mico/state.h"
+#include "mico/builtin.h"
+#include "mico/expressions.h"
+#include "mico/statements.h"
+#include "mico/eval/tree_walking.h"
+#include "mico/macro/processor.h"
+
+namespace mico { namespace eval {
+
+    /// Constant folding and dead branches.
+    /// Runs after the macros and before the resolver. An operator whose
+    /// operands are literals is evaluated once and replaced by the
+    /// literal of its result; the tree is folded bottom up, so whole
+    /// expressions of literals become one node. Intervals keep their
+    /// node, their bounds are folded. An 'if', 'elif' or 'unless' with a
+    /// literal condition loses the branches that can never run.
+    /// Anything that fails (1 / 0) is left as it is for the runtime to
+    /// report at the right place.
+    /// A call of a pure function with literal arguments is made here too.
+    /// A function is pure if it is bound by 'let' and uses nothing but
+    /// its own names, other pure functions, 'let' constants and 'len',
+    /// 'copy' and 'string'. The call runs in an environment that has
+    /// only these, with a step budget, after the 'let's it needs.
+    /// With 'inline_calls' a call of a small function bound by 'let'
+    /// that is not recursive and has no 'return' becomes its body in
+    /// a scope that binds the parameters.
+    class folder {
+
+        using ifelse = ast::expressions::ifelse;
+        using infix  = ast::expressions::infix;
+        using prefix = ast::expressions::prefix;
+
+        /// longer strings are not put into the tree: "-" * 1000000
+        static const std::size_t max_string = 4096;
+
+        /// scopes a call may evaluate and all the calls together
+        static const std::size_t call_steps  = 100000;
+        static const std::size_t total_steps = 1000000;
+
+        /// nodes of the biggest body that is inlined
+        static const std::size_t max_inline = 32;
+
+        /// a name of a scope as far as the folder knows it
+        struct frame;
+        struct binding {
+            enum class kind {
+                /// anything that is not a function or a literal
+                OTHER,
+                /// 'let' that is not done yet
+                PENDING,
+                FUNC,
+                VALUE,
+            };
+            std::string               name;
+            kind                      what    = kind::OTHER;
+            const ast::node          *let     = nullptr;
+            ast::node                *value   = nullptr;
+            frame                    *owner   = nullptr;
+            /// -1 not checked, 0 impure, 1 the body itself is pure
+            int                       checked = -1;
+            std::vector<binding *>    deps;
+        };
+
+        struct frame {
+            frame                                    *parent = nullptr;
+            std::map<std::string, std::unique_ptr<binding> > names;
+        };
+
+    public:
+
+        struct report {
+            std::size_t nodes_before = 0;
+            std::size_t nodes_after  = 0;
+            std::size_t folded       = 0;
+            std::size_t pruned       = 0;
+            std::size_t calls        = 0;
+            std::size_t inlined      = 0;
+            double      seconds      = 0;
+        };
+
+        /// bodies of functions that are not parsed yet (--lazy) are
+        /// folded when they are parsed and are not in the report
+        static
+        report process( ast::node *n, bool inline_calls = false )
+        {
+            using clock = std::chrono::steady_clock;
+            report res;
+            res.nodes_before = count( n );
+            auto start = clock::now( );
+
+            folder f(inline_calls);
+            f.fold( n );
+
+            std::chrono::duration<double> spent = clock::now( ) - start;
+            res.seconds     = spent.count( );
+            res.folded      = f.folded_;
+            res.pruned      = f.pruned_;
+            res.calls       = f.calls_;
+            res.inlined     = f.inlined_;
+            res.nodes_after = count( n );
+            return res;
+        }
+
+        /// nodes in the tree; an unparsed body is one node
+        static
+        std::size_t count( ast::node *n )
+        {
+            if( !n ) {
+                return 0;
+            }
+            if( n->get_type( ) == ast::type::LAZY ) {
+                auto lz = ast::cast<ast::expressions::lazy>( n );
+                return lz->ready( ) ? count( lz->get( ).get( ) ) : 1;
+            }
+            std::size_t res = 1;
+            n->mutate( [&res]( ast::node *c ) {
+                res += count( c );
+                return ast::node::uptr( );
+            } );
+            return res;
+        }
+
+    private:
+
+        explicit
+        folder( bool inline_calls )
+            :inline_(inline_calls)
+        {
+            auto env = st_.env( );
+            env->set_const( "len",  common::make( env, len { } ) );
+            env->set_const( "copy", common::make( env, copy { } ) );
+            modules::string::load( env );
+        }
+
+        ast::node::uptr fold( ast::node *n )
+        {
+            switch( n->get_type( ) ) {
+            case ast::type::PROGRAM:
+                push( );
+                declare( ast::cast<ast::program>( n )->states( ) );
+                children( n );
+                pop( );
+                break;
+            case ast::type::LIST: {
+                auto lst = ast::cast<ast::expressions::list>( n );
+                bool scope = lst->get_role( ) == list_role::LIST_SCOPE;
+                if( scope ) {
+                    push( );
+                    declare( lst->value( ) );
+                }
+                children( n );
+                if( scope ) {
+                    pop( );
+                }
+                break;
+            }
+            case ast::type::FN: {
+                push( );
+                std::set<std::string> names;
+                params( ast::cast<function>( n ), names );
+                for( auto &p: names ) {
+                    hide( p );
+                }
+                children( n );
+                pop( );
+                break;
+            }
+            case ast::type::FORIN: {
+                push( );
+                auto fori = ast::cast<ast::expressions::forin>( n );
+                for( auto &i: fori->idents( )->value( ) ) {
+                    hide( name_of( i.get( ) ) );
+                }
+                children( n );
+                pop( );
+                break;
+            }
+            case ast::type::LET:
+                children( n );
+                done( ast::cast<ast::statements::let>( n ) );
+                break;
+            case ast::type::CALL:
+                children( n );
+                return fold_call( ast::cast<ast::expressions::call>( n ) );
+            case ast::type::LAZY:
+                fold_lazy( ast::cast<ast::expressions::lazy>( n ), inline_ );
+                return nullptr;
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+            /// a quoted tree is a value; folding it changes the program
+            case ast::type::QUOTE:
+            case ast::type::MACRO:
+                return nullptr;
+#endif
+            case ast::type::INFIX:
+                children( n );
+                return fold_infix( ast::cast<infix>( n ) );
+            case ast::type::PREFIX:
+                children( n );
+                return fold_prefix( ast::cast<prefix>( n ) );
+            case ast::type::IFELSE:
+                return fold_ifelse( ast::cast<ifelse>( n ) );
+            default:
+                children( n );
+                break;
+            }
+            return nullptr;
+        }
+
+        void children( ast::node *n )
+        {
+            n->mutate( [this]( ast::node *c ) {
+                return fold( c );
+            } );
+        }
+
+        static
+        void fold_lazy( ast::expressions::lazy *body, bool inline_calls )
+        {
+            body->defer( [inline_calls]( ast::node::uptr &n,
+                                         std::vector<std::string> & ) {
+                folder f(inline_calls);
+                ast::node::apply_mutator( n, [&f]( ast::node *c ) {
+                    return f.fold( c );
+                } );
+            } );
+        }
+
+        static
+        bool is_literal( const ast::node *n )
+        {
+            switch( n->get_type( ) ) {
+            case ast::type::INTEGER:
+            case ast::type::FLOAT:
+            case ast::type::BOOLEAN:
+            case ast::type::STRING:
+            case ast::type::CHARACTER:
+                return true;
+            default:
+                break;
+            }
+            return false;
+        }
+
+        ast::node::uptr fold_infix( infix *n )
+        {
+            using TT = tokens::type;
+            switch( n->token( ) ) {
+            case TT::PLUS:      case TT::MINUS:
+            case TT::ASTERISK:  case TT::SLASH:     case TT::PERCENT:
+            case TT::EQ:        case TT::NOT_EQ:
+            case TT::LT:        case TT::GT:
+            case TT::LT_EQ:     case TT::GT_EQ:
+            case TT::LOGIC_AND: case TT::LOGIC_OR:
+            case TT::BIT_AND:   case TT::BIT_OR:    case TT::BIT_XOR:
+            case TT::SHIFT_LEFT:
+            case TT::SHIFT_RIGHT:
+                break;
+            default:
+                return nullptr;
+            }
+            if( !is_literal( n->left( ).get( ) ) ||
+                !is_literal( n->right( ).get( ) ) ) {
+                return nullptr;
+            }
+            return replace( n );
+        }
+
+        ast::node::uptr fold_prefix( prefix *n )
+        {
+            using TT = tokens::type;
+            switch( n->token( ) ) {
+            case TT::MINUS: case TT::BANG: case TT::TILDA:
+                break;
+            default:
+                return nullptr;
+            }
+            if( !is_literal( n->value( ).get( ) ) ) {
+                return nullptr;
+            }
+            return replace( n );
+        }
+
+        /// the literal of the value of 'n' or nullptr
+        ast::node::uptr replace( ast::node *n )
+        {
+            auto obj = tv_.eval( n, st_.env( ) );
+            if( obj->get_type( ) == objects::type::ARRAY
+             || obj->get_type( ) == objects::type::TABLE ) {
+                return nullptr;
+            }
+            auto res = literal_of( obj, n->pos( ) );
+            folded_ += res ? 1 : 0;
+            return res;
+        }
+
+        /// the literal of 'obj'; scalars, or an array or a table of them
+        static
+        ast::node::uptr literal_of( const objects::sptr &obj,
+                                    tokens::position pos )
+        {
+            switch( obj->get_type( ) ) {
+            case objects::type::INTEGER:
+            case objects::type::FLOAT:
+            case objects::type::BOOLEAN:
+            case objects::type::CHARACTER:
+                break;
+            case objects::type::STRING:
+                if( objects::cast_string( obj.get( ) )->value( ).size( )
+                                                        > max_string ) {
+                    return nullptr;
+                }
+                break;
+            case objects::type::RSTRING:
+                if( objects::cast_rstring( obj.get( ) )->value( ).size( )
+                                                        > max_string ) {
+                    return nullptr;
+                }
+                break;
+            case objects::type::ARRAY:
+            case objects::type::TABLE: {
+                auto res = obj->to_ast( pos );
+                std::size_t size = 0;
+                return plain( res.get( ), false, size ) ? std::move(res)
+                                                        : nullptr;
+            }
+            default:
+                return nullptr;
+            }
+            return obj->to_ast( pos );
+        }
+
+        /// a flat container of literals; two elements of a nested one
+        /// could be the same object, its literal would make two
+        static
+        bool plain( ast::node *n, bool inside, std::size_t &size )
+        {
+            if( !n || ++size > max_string ) {
+                return false;
+            }
+            switch( n->get_type( ) ) {
+            case ast::type::MOD_MUT:
+            case ast::type::ARRAY:
+            case ast::type::TABLE:
+                if( inside ) {
+                    return false;
+                }
+                break;
+            default:
+                return is_literal( n );
+            }
+            bool res = true;
+            n->mutate( [&res, &size]( ast::node *c ) {
+                res = res && plain( c, true, size );
+                return ast::node::uptr( );
+            } );
+            return res;
+        }
+
+        /////////////// pure calls ///////////////
+
+        using function  = ast::expressions::function;
+        using list_role = ast::expressions::list::role;
+        using kind      = binding::kind;
+
+        void push( )
+        {
+            std::unique_ptr<frame> next(new frame);
+            next->parent = frames_.empty( ) ? nullptr
+                                            : frames_.back( ).get( );
+            frames_.emplace_back( std::move(next) );
+        }
+
+        void pop( )
+        {
+            frames_.pop_back( );
+        }
+
+        /// 'name' is something unknown in the current scope
+        void hide( const std::string &name )
+        {
+            auto &b( frames_.back( )->names[name] );
+            b.reset( new binding );
+            b->name  = name;
+            b->owner = frames_.back( ).get( );
+        }
+
+        /// the 'let's of a scope; a name bound twice or by 'var' is
+        /// not a constant
+        void declare( const ast::node_list &states )
+        {
+            for( auto &s: states ) {
+                if( s->get_type( ) != ast::type::LET ) {
+                    continue;
+                }
+                auto let = ast::cast<ast::statements::let>( s.get( ) );
+                if( let->ident( )->get_type( ) != ast::type::IDENT ) {
+                    continue;
+                }
+                auto name = name_of( let->ident( ).get( ) );
+                bool again = frames_.back( )->names.count( name ) != 0;
+                hide( name );
+                if( !again && !let->mut( ) ) {
+                    auto &b( frames_.back( )->names[name] );
+                    b->what = kind::PENDING;
+                    b->let  = let;
+                }
+            }
+        }
+
+        /// the 'let' has run; what it binds can be used from now on
+        void done( ast::statements::let *let )
+        {
+            if( frames_.empty( ) ) {
+                return;
+            }
+            auto &names( frames_.back( )->names );
+            auto f = names.find( name_of( let->ident( ).get( ) ) );
+            if( f == names.end( ) || f->second->let != let ) {
+                return;
+            }
+            auto b = f->second.get( );
+            b->value = let->value( ).get( );
+            if( b->value->get_type( ) == ast::type::FN ) {
+                b->what = kind::FUNC;
+            } else if( is_literal( b->value ) ) {
+                b->what = kind::VALUE;
+            } else {
+                b->what = kind::OTHER;
+            }
+        }
+
+        static
+        binding *find( frame *from, const std::string &name )
+        {
+            for( ; from; from = from->parent ) {
+                auto f = from->names.find( name );
+                if( f != from->names.end( ) ) {
+                    return f->second.get( );
+                }
+            }
+            return nullptr;
+        }
+
+        /// the name that 'n' binds or calls. 'str' is the name of the
+        /// source; the locals of an inlined body get a suffix
+        static
+        std::string name_of( ast::node *n )
+        {
+            if( n->get_type( ) == ast::type::IDENT ) {
+                return ast::cast<ast::expressions::ident>( n )->value( );
+            }
+            return n->str( );
+        }
+
+        static
+        void params( function *func, std::set<std::string> &names )
+        {
+            for( auto &i: func->inits( ) ) {
+                names.insert( i.first );
+            }
+            for( auto &p: func->params( )->value( ) ) {
+                if( p->get_type( ) == ast::type::IDENT ) {
+                    names.insert( name_of( p.get( ) ) );
+                } else if( p->get_type( ) == ast::type::ELIPSIS ) {
+                    auto eli = ast::cast<ast::expressions::elipsis>(
+                                                                p.get( ) );
+                    names.insert( eli->is_ident( )
+                                ? name_of( eli->value( ).get( ) )
+                                : "__args" );
+                }
+            }
+        }
+
+        /// names a function binds itself; all of them for the whole
+        /// body, a wrong guess only makes the call fail and stay
+        static
+        void locals( ast::node *n, std::set<std::string> &names )
+        {
+            /// a body that is not parsed is not pure anyway
+            if( !n || n->get_type( ) == ast::type::LAZY ) {
+                return;
+            }
+            switch( n->get_type( ) ) {
+            case ast::type::LET: {
+                auto let = ast::cast<ast::statements::let>( n );
+                names.insert( name_of( let->ident( ).get( ) ) );
+                break;
+            }
+            case ast::type::FN:
+                params( ast::cast<function>( n ), names );
+                break;
+            case ast::type::FORIN: {
+                auto fori = ast::cast<ast::expressions::forin>( n );
+                for( auto &i: fori->idents( )->value( ) ) {
+                    names.insert( name_of( i.get( ) ) );
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            n->mutate( [&names]( ast::node *c ) {
+                locals( c, names );
+                return ast::node::uptr( );
+            } );
+        }
+
+        /// false if 'n' uses anything that is not pure; the functions
+        /// and constants it uses go to 'b->deps'
+        static
+        bool uses( ast::node *n, const std::set<std::string> &names,
+                   binding *b )
+        {
+            if( !n ) {
+                return true;
+            }
+            auto chld = [&names, b]( ast::node *c ) {
+                return uses( c, names, b );
+            };
+            switch( n->get_type( ) ) {
+            case ast::type::IDENT: {
+                auto &name( ast::cast<ast::expressions::ident>( n )
+                                                               ->value( ) );
+                if( names.count( name ) ) {
+                    return true;
+                }
+                if( auto dep = find( b->owner, name ) ) {
+                    if( dep->what == kind::OTHER ) {
+                        return false;
+                    }
+                    b->deps.push_back( dep );
+                    return true;
+                }
+                return name == "len" || name == "copy" || name == "string";
+            }
+            case ast::type::LET:
+                return chld( ast::cast<ast::statements::let>( n )
+                                                       ->value( ).get( ) );
+            case ast::type::FORIN: {
+                auto fori = ast::cast<ast::expressions::forin>( n );
+                return chld( fori->expres( ).get( ) )
+                    && chld( fori->body( ).get( ) );
+            }
+            case ast::type::FN: {
+                auto func = ast::cast<function>( n );
+                for( auto &i: func->inits( ) ) {
+                    if( !chld( i.second.get( ) ) ) {
+                        return false;
+                    }
+                }
+                return chld( func->body( ).get( ) );
+            }
+            case ast::type::INFIX: {
+                auto inf = ast::cast<infix>( n );
+                if( inf->token( ) != tokens::type::DOT ) {
+                    break;
+                }
+                /// module members are not variables
+                auto right = inf->right( ).get( );
+                if( right->get_type( ) == ast::type::CALL ) {
+                    auto call = ast::cast<ast::expressions::call>( right );
+                    for( auto &p: call->param_list( ) ) {
+                        if( !chld( p.get( ) ) ) {
+                            return false;
+                        }
+                    }
+                } else if( right->get_type( ) != ast::type::IDENT ) {
+                    if( !chld( right ) ) {
+                        return false;
+                    }
+                }
+                return chld( inf->left( ).get( ) );
+            }
+            case ast::type::LAZY:
+            case ast::type::REGISTRY:
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+            case ast::type::QUOTE:
+            case ast::type::UNQUOTE:
+            case ast::type::MACRO:
+            case ast::type::BUILTIN_MACRO:
+#endif
+                return false;
+            default:
+                break;
+            }
+            bool res = true;
+            n->mutate( [&res, &chld]( ast::node *c ) {
+                res = res && chld( c );
+                return ast::node::uptr( );
+            } );
+            return res;
+        }
+
+        static
+        bool check( binding *b )
+        {
+            if( b->checked < 0 ) {
+                auto func = ast::cast<function>( b->value );
+                std::set<std::string> names;
+                locals( func, names );
+                b->checked = uses( func, names, b ) ? 1 : 0;
+            }
+            return b->checked == 1;
+        }
+
+        /// 'b' and everything it needs; false if something is not pure
+        /// or not bound yet
+        static
+        bool closure( binding *b, std::vector<binding *> &res )
+        {
+            std::set<binding *> seen;
+            std::set<std::string> names;
+            std::vector<binding *> next( 1, b );
+            while( !next.empty( ) ) {
+                auto cur = next.back( );
+                next.pop_back( );
+                if( !seen.insert( cur ).second ) {
+                    continue;
+                }
+                /// two functions with the same name can't share the
+                /// environment
+                if( !names.insert( cur->name ).second ) {
+                    return false;
+                }
+                if( cur->what == kind::VALUE ) {
+                    res.push_back( cur );
+                    continue;
+                }
+                if( cur->what != kind::FUNC || !check( cur ) ) {
+                    return false;
+                }
+                res.push_back( cur );
+                next.insert( next.end( ), cur->deps.begin( ),
+                                          cur->deps.end( ) );
+            }
+            return true;
+        }
+
+        ast::node::uptr fold_call( ast::expressions::call *n )
+        {
+            if( frames_.empty( )
+             || n->func( )->get_type( ) != ast::type::IDENT ) {
+                return nullptr;
+            }
+            if( auto res = pure_call( n ) ) {
+                return res;
+            }
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+            if( inline_ ) {
+                return inline_call( n );
+            }
+#endif
+            return nullptr;
+        }
+
+        ast::node::uptr pure_call( ast::expressions::call *n )
+        {
+            if( steps_ >= total_steps ) {
+                return nullptr;
+            }
+            for( auto &p: n->param_list( ) ) {
+                if( !is_literal( p.get( ) ) ) {
+                    return nullptr;
+                }
+            }
+            auto b = find( frames_.back( ).get( ),
+                           name_of( n->func( ).get( ) ) );
+            std::vector<binding *> need;
+            if( !b || b->what != kind::FUNC || !closure( b, need ) ) {
+                return nullptr;
+            }
+
+            environment::scoped s(environment::make( st_.env( ) ));
+            for( auto d: need ) {
+                auto obj = tv_.eval( d->value, s.env( ) );
+                if( obj->get_type( ) == objects::type::FAILURE ) {
+                    return nullptr;
+                }
+                s.env( )->set_const( d->name, obj );
+            }
+
+            auto left = total_steps - steps_;
+            tv_.set_budget( left < call_steps ? left : call_steps );
+            auto obj = tv_.eval( n, s.env( ) );
+            steps_ += tv_.steps( );
+            tv_.set_budget( 0 );
+
+            if( obj->get_type( ) == objects::type::REFERENCE ) {
+                obj = objects::cast_ref( obj.get( ) )->value( );
+            }
+            auto res = literal_of( obj, n->pos( ) );
+            calls_ += res ? 1 : 0;
+            return res;
+        }
+
+        /////////////// inlining ///////////////
+
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+
+        /// a body that is checked for a call
+        struct site {
+            /// every name the function binds
+            std::set<std::string>  names;
+            /// the names that are bound at the current node
+            std::set<std::string>  bound;
+            binding               *func = nullptr;
+            frame                 *at   = nullptr;
+            std::size_t            size = 0;
+        };
+
+        /// false if the body can not be put at the call: it is too big,
+        /// it leaves the function ('return', 'break'), makes closures,
+        /// calls itself, a name that it does not bind means something
+        /// else at the call, or it uses its own name before the 'let'
+        static
+        bool inlinable( ast::node *n, site &st )
+        {
+            if( !n ) {
+                return true;
+            }
+            if( ++st.size > max_inline ) {
+                return false;
+            }
+            auto chld = [&st]( ast::node *c ) {
+                return inlinable( c, st );
+            };
+            switch( n->get_type( ) ) {
+            case ast::type::IDENT: {
+                auto &name( ast::cast<ast::expressions::ident>( n )
+                                                               ->value( ) );
+                if( st.names.count( name ) ) {
+                    return st.bound.count( name ) != 0;
+                }
+                auto def = find( st.func->owner, name );
+                return def != st.func && find( st.at, name ) == def;
+            }
+            case ast::type::LET: {
+                auto let = ast::cast<ast::statements::let>( n );
+                if( !chld( let->value( ).get( ) ) ) {
+                    return false;
+                }
+                st.bound.insert( name_of( let->ident( ).get( ) ) );
+                return true;
+            }
+            case ast::type::LIST: {
+                auto lst = ast::cast<ast::expressions::list>( n );
+                if( lst->get_role( ) != list_role::LIST_SCOPE ) {
+                    break;
+                }
+                auto outer = st.bound;
+                bool res = true;
+                for( auto &c: lst->value( ) ) {
+                    res = res && chld( c.get( ) );
+                }
+                st.bound.swap( outer );
+                return res;
+            }
+            case ast::type::FORIN: {
+                auto fori = ast::cast<ast::expressions::forin>( n );
+                if( !chld( fori->expres( ).get( ) ) ) {
+                    return false;
+                }
+                auto outer = st.bound;
+                for( auto &i: fori->idents( )->value( ) ) {
+                    st.bound.insert( name_of( i.get( ) ) );
+                }
+                bool res = chld( fori->body( ).get( ) );
+                st.bound.swap( outer );
+                return res;
+            }
+            case ast::type::INFIX: {
+                auto inf = ast::cast<infix>( n );
+                if( inf->token( ) != tokens::type::DOT ) {
+                    break;
+                }
+                /// members keep their names; the renaming would not
+                if( !chld( inf->left( ).get( ) ) ) {
+                    return false;
+                }
+                auto right = inf->right( ).get( );
+                ast::node *member = right;
+                if( right->get_type( ) == ast::type::CALL ) {
+                    auto call = ast::cast<ast::expressions::call>( right );
+                    member = call->func( ).get( );
+                    for( auto &p: call->param_list( ) ) {
+                        if( !chld( p.get( ) ) ) {
+                            return false;
+                        }
+                    }
+                }
+                if( member->get_type( ) == ast::type::IDENT ) {
+                    return st.names.count( name_of( member ) ) == 0;
+                }
+                return chld( member );
+            }
+            case ast::type::FN:
+            case ast::type::LAZY:
+            case ast::type::RETURN:
+            case ast::type::BREAK:
+            case ast::type::CONTINUE:
+            case ast::type::MODULE:
+            case ast::type::REGISTRY:
+            case ast::type::QUOTE:
+            case ast::type::UNQUOTE:
+            case ast::type::MACRO:
+            case ast::type::BUILTIN_MACRO:
+                return false;
+            default:
+                break;
+            }
+            bool res = true;
+            n->mutate( [&res, &chld]( ast::node *c ) {
+                res = res && chld( c );
+                return ast::node::uptr( );
+            } );
+            return res;
+        }
+
+        /// { var x@1 = arg; ...body }; the body is the folded one. Its
+        /// names get a suffix that no program can write, the macro
+        /// processor renames them as it does with the macro parameters
+        ast::node::uptr inline_call( ast::expressions::call *n )
+        {
+            using ident = ast::expressions::ident;
+            using let   = ast::statements::let;
+
+            auto at = frames_.back( ).get( );
+            auto b  = find( at, name_of( n->func( ).get( ) ) );
+            if( !b || b->what != kind::FUNC ) {
+                return nullptr;
+            }
+            auto func = ast::cast<function>( b->value );
+            auto &pars( func->params( )->value( ) );
+            auto &args( n->param_list( ) );
+            if( !func->inits( ).empty( ) || pars.size( ) != args.size( )
+             || func->body( )->get_type( ) != ast::type::LIST ) {
+                return nullptr;
+            }
+            site st;
+            st.func = b;
+            st.at   = at;
+            for( auto &p: pars ) {
+                if( p->get_type( ) != ast::type::IDENT ) {
+                    return nullptr;
+                }
+                st.bound.insert( name_of( p.get( ) ) );
+            }
+            st.names = st.bound;
+            locals( func->body( ).get( ), st.names );
+            if( !inlinable( func->body( ).get( ), st ) ) {
+                return nullptr;
+            }
+
+            auto suffix = "@" + std::to_string( next_site( ) );
+            macro::processor::scope renames;
+            for( auto &name: st.names ) {
+                renames.set( name, ident::make( name + suffix,
+                                                source_name( name ) ) );
+            }
+
+            auto res = ast::expressions::list::make_scope( );
+            res->set_pos( n->pos( ) );
+            for( std::size_t i = 0; i < pars.size( ); ++i ) {
+                auto id = ident::make( name_of( pars[i].get( ) ) + suffix,
+                                       pars[i]->str( ) );
+                id->set_pos( pars[i]->pos( ) );
+                auto bind = let::make( std::move(id), std::move(args[i]) );
+                bind->set_pos( n->pos( ) );
+                res->value( ).emplace_back( std::move(bind) );
+            }
+
+            auto body = func->body( )->clone( );
+            macro::processor::error_list errs;
+            macro::processor::macro_mutator( body.get( ), &renames, &errs,
+                                             macro::processor::eval_call( ) );
+            auto lst = ast::cast<ast::expressions::list>( body.get( ) );
+            for( auto &s: lst->value( ) ) {
+                res->value( ).emplace_back( std::move(s) );
+            }
+            ++inlined_;
+            return ast::node::uptr( std::move(res) );
+        }
+
+        /// 'x@1@2' is 'x' in the source
+        static
+        std::string source_name( const std::string &name )
+        {
+            return name.substr( 0, name.find( '@' ) );
+        }
+
+        /// the folders of bodies parsed later share the names
+        static
+        std::size_t next_site( )
+        {
+            static std::size_t last = 0;
+            return ++last;
+        }
+#endif
+
+        /// 1 if 'cond' always passes, 0 if it never does, -1 if unknown
+        static
+        int passes( ast::node *cond, bool unless )
+        {
+            int res = -1;
+            switch( cond->get_type( ) ) {
+            case ast::type::BOOLEAN:
+                res = ast::cast<ast::expressions::boolean>( cond )
+                                                        ->value( ) ? 1 : 0;
+                break;
+            case ast::type::INTEGER:
+                res = ast::cast<ast::expressions::integer>( cond )
+                                                        ->value( ) ? 1 : 0;
+                break;
+            case ast::type::FLOAT:
+                res = ast::cast<ast::expressions::floating>( cond )
+                                                        ->value( ) ? 1 : 0;
+                break;
+            default:
+                return -1;
+            }
+            return unless ? 1 - res : res;
+        }
+
+        /// conditions first; a branch that is dropped is not folded
+        ast::node::uptr fold_ifelse( ifelse *n )
+        {
+            auto call = [this]( ast::node *c ) {
+                return fold( c );
+            };
+            for( auto &i: n->ifs( ) ) {
+                ast::expression::apply_mutator( i.cond, call );
+            }
+            auto res = prune( n );
+            if( res ) {
+                return res;
+            }
+            for( auto &i: n->ifs( ) ) {
+                ast::expression::apply_mutator( i.body, call );
+            }
+            if( n->alt( ) ) {
+                ast::expression::apply_mutator( n->alt( ), call );
+            }
+            return nullptr;
+        }
+
+        /// the branches stay in an 'if' with their own environments; a
+        /// branch that always runs gets a literal condition
+        ast::node::uptr prune( ifelse *n )
+        {
+            bool unless = n->is_unless( );
+            ifelse::if_list keep;
+            bool taken = false;
+            for( auto &i: n->ifs( ) ) {
+                int pass = taken ? 0 : passes( i.cond.get( ), unless );
+                if( pass == 0 ) {
+                    ++pruned_;
+                    continue;
+                }
+                taken = ( pass == 1 );
+                keep.emplace_back( std::move(i) );
+            }
+            if( taken && n->alt( ) ) {
+                n->alt( ).reset( );
+                ++pruned_;
+            }
+            if( keep.empty( ) ) {
+                if( !n->alt( ) ) {
+                    auto res = ast::expressions::null::make( );
+                    res->set_pos( n->pos( ) );
+                    return res;
+                }
+                ifelse::node always;
+                always.cond = ast::expressions::boolean::make( !unless );
+                always.cond->set_pos( n->alt( )->pos( ) );
+                always.body = std::move(n->alt( ));
+                keep.emplace_back( std::move(always) );
+            }
+            n->ifs( ).swap( keep );
+            return nullptr;
+        }
+
+        state                                st_;
+        tree_walking                         tv_;
+        std::vector<std::unique_ptr<frame> > frames_;
+        std::size_t                          folded_  = 0;
+        std::size_t                          pruned_  = 0;
+        std::size_t                          calls_   = 0;
+        std::size_t                          steps_   = 0;
+        std::size_t                          inlined_ = 0;
+        bool                                 inline_  = false;
+    };
+
+}}
+
+#endif // MICO_EVAL_FOLDER_H
@@ -11,18 +11,21 @@
 
 namespace mico { namespace eval { namespace operations {
 
+    /// operands and environments are borrowed for the time of the call
     using eval_call = std::function<objects::sptr (ast::node *,
-                                                   environment::sptr)>;
+                                            const environment::sptr &)>;
 
     template <objects::type T>
     struct operation;
     /*
-     *  objects::sptr eval_prefix( tokens::type, objects::sptr );
-     *  objects::sptr eval_infix( tokens::type, objects::sptr,
-     *                            ast::node *, eval_call );
+     *  objects::sptr eval_prefix( prefix *, const objects::sptr & );
+     *  objects::sptr eval_infix( infix *, const objects::sptr &,
+     *                            const eval_call &,
+     *                            const environment::sptr & );
      *
-     *  objects::sptr eval_index( index *idx, objects::sptr obj,
-     *                            eval_call ev, environment::sptr env );
+     *  objects::sptr eval_index( index *idx, const objects::sptr &obj,
+     *                            const eval_call &ev,
+     *                            const environment::sptr &env );
      *
     */
 }}}
@@ -16,7 +16,7 @@ namespace mico { namespace eval { namespace operations {
         using index      = ast::expressions::index;
 
         static
-        objects::sptr eval_prefix( prefix *pref, objects::sptr obj )
+        objects::sptr eval_prefix( prefix *pref, const objects::sptr &obj )
         {
             common::reference<objects::type::ARRAY> ref(obj);
             auto tt = ref.unref( );
@@ -30,8 +30,9 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_array( environment::sptr env,
-                                  objects::sptr lft, objects::sptr rght )
+        objects::sptr eval_array( const environment::sptr &env,
+                                  const objects::sptr &lft,
+                                  const objects::sptr &rght )
         {
             auto ltable = objects::cast_array(lft);
             auto rtable = objects::cast_array(rght);
@@ -49,14 +50,15 @@ namespace mico { namespace eval { namespace operations {
         static
         objects::sptr eval_ival_index( index *idx,
                                        objects::array::sptr str,
-                                       objects::sptr id )
+                                       const objects::sptr &id )
         {
             return common::eval_ival_index<objects::array>(idx, str, id);
         }
 
         static
-        objects::sptr eval_index( index *idx, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_index( index *idx, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<objects::type::ARRAY> ref(obj);
             auto arr = ref.shared_unref( );
@@ -87,11 +89,12 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &left,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
-            common::reference<objects::type::ARRAY> ref(obj);
-            obj = ref.shared_unref( );
+            common::reference<objects::type::ARRAY> ref(left);
+            objects::sptr obj = ref.shared_unref( );
 
             objects::sptr right = ev( inf->right( ).get( ), env );
             if( right->get_type( ) == objects::type::FAILURE ) {
@@ -0,0 +1,269 @@
+#ifndef MICO_EVAL_BINARY_OPERATIONS_H
+#define MICO_EVAL_BINARY_OPERATIONS_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "mico/eval/operation.h"
+#include "mico/tokens.h"
+#include "mico/eval/operations/integer.h"
+#include "mico/eval/operations/float.h"
+#include "mico/eval/operations/boolean.h"
+#include "mico/eval/operations/character.h"
+#include "mico/eval/operations/string.h"
+#include "mico/eval/operations/rstring.h"
+
+namespace mico { namespace eval { namespace operations {
+
+    /// [left type][right type][operator] -> operation on two values.
+    /// The table is filled from the operation<T> specializations; an
+    /// empty cell leaves the pair to the generic path of the evaluator.
+    /// Builtins can add or replace cells with 'set'.
+    /// LOGIC_AND and LOGIC_OR are not here: their right operand is
+    /// evaluated only when the left one asks for it.
+    class binary {
+
+    public:
+
+        using infix    = ast::expressions::infix;
+        using function = objects::sptr (*)( infix *,
+                                            const objects::sptr &,
+                                            const objects::sptr &,
+                                            const environment::sptr & );
+
+        static const std::size_t npos = static_cast<std::size_t>(-1);
+
+        static
+        binary &instance( )
+        {
+            static binary res;
+            return res;
+        }
+
+        /// the operator slot of 'tt' or npos
+        static
+        std::size_t slot( tokens::type tt )
+        {
+            using TT = tokens::type;
+            switch( tt ) {
+            case TT::MINUS:    case TT::PLUS:
+            case TT::ASTERISK: case TT::SLASH:       case TT::PERCENT:
+            case TT::EQ:       case TT::NOT_EQ:
+            case TT::BIT_OR:   case TT::BIT_XOR:     case TT::BIT_AND:
+            case TT::SHIFT_RIGHT: case TT::SHIFT_LEFT:
+            case TT::LT:       case TT::GT:
+            case TT::LT_EQ:    case TT::GT_EQ:
+                return static_cast<std::size_t>(tt)
+                     - static_cast<std::size_t>(TT::MINUS);
+            case TT::DOTDOT:
+                return row_slots;
+            case TT::OP_IN:
+                return row_slots + 1;
+            }
+            return npos;
+        }
+
+        function get( objects::type lt, objects::type rt,
+                      tokens::type tt ) const
+        {
+            auto s = slot( tt );
+            return s == npos ? nullptr : table_[cell( lt, rt, s )];
+        }
+
+        /// some operation for 'lt' and 'tt' is here; the right operand
+        /// has to be evaluated to find it
+        bool has( objects::type lt, tokens::type tt ) const
+        {
+            auto s = slot( tt );
+            return s != npos && rows_[row( lt, s )];
+        }
+
+        bool set( objects::type lt, objects::type rt, tokens::type tt,
+                  function call )
+        {
+            auto s = slot( tt );
+            if( s == npos ) {
+                return false;
+            }
+            table_[cell( lt, rt, s )] = call;
+            if( call ) {
+                rows_[row( lt, s )] = 1;
+            }
+            return true;
+        }
+
+    private:
+
+        static const std::size_t types =
+                static_cast<std::size_t>(objects::type::TYPE_OBJ) + 1;
+
+        /// MINUS ... GT_EQ
+        static const std::size_t row_slots =
+                static_cast<std::size_t>(tokens::type::GT_EQ)
+              - static_cast<std::size_t>(tokens::type::MINUS) + 1;
+
+        static const std::size_t slots = row_slots + 2;
+
+        static
+        std::size_t row( objects::type lt, std::size_t s )
+        {
+            return static_cast<std::size_t>(lt) * slots + s;
+        }
+
+        static
+        std::size_t cell( objects::type lt, objects::type rt, std::size_t s )
+        {
+            return ( static_cast<std::size_t>(lt) * types
+                   + static_cast<std::size_t>(rt) ) * slots + s;
+        }
+
+        static
+        std::int64_t to_int( const objects::base *o )
+        {
+            using OT = objects::type;
+            switch( o->get_type( ) ) {
+            case OT::CHARACTER:
+                return static_cast<std::int64_t>(
+                            objects::cast<OT::CHARACTER>( o )->value( ) );
+            case OT::BOOLEAN:
+                return objects::cast<OT::BOOLEAN>( o )->value( ) ? 1 : 0;
+            case OT::FLOAT:
+                return static_cast<std::int64_t>(
+                            objects::cast<OT::FLOAT>( o )->value( ) );
+            default:
+                break;
+            }
+            return objects::cast<OT::INTEGER>( o )->value( );
+        }
+
+        static
+        double to_float( const objects::base *o )
+        {
+            using OT = objects::type;
+            switch( o->get_type( ) ) {
+            case OT::INTEGER:
+                return static_cast<double>(
+                            objects::cast<OT::INTEGER>( o )->value( ) );
+            case OT::CHARACTER:
+                return static_cast<double>(
+                            objects::cast<OT::CHARACTER>( o )->value( ) );
+            case OT::BOOLEAN:
+                return objects::cast<OT::BOOLEAN>( o )->value( ) ? 1.0 : 0.0;
+            default:
+                break;
+            }
+            return objects::cast<OT::FLOAT>( o )->value( );
+        }
+
+        static
+        objects::sptr int_int( infix *inf, const objects::sptr &lft,
+                               const objects::sptr &rght,
+                               const environment::sptr & )
+        {
+            return operation<objects::type::INTEGER>::eval_int( inf,
+                            to_int( lft.get( ) ), to_int( rght.get( ) ) );
+        }
+
+        static
+        objects::sptr num_float( infix *inf, const objects::sptr &lft,
+                                 const objects::sptr &rght,
+                                 const environment::sptr & )
+        {
+            return operation<objects::type::INTEGER>::eval_float( inf,
+                        to_float( lft.get( ) ), to_float( rght.get( ) ) );
+        }
+
+        static
+        objects::sptr bool_bool( infix *inf, const objects::sptr &lft,
+                                 const objects::sptr &rght,
+                                 const environment::sptr & )
+        {
+            return operation<objects::type::BOOLEAN>::eval_bool( inf,
+                            objects::cast_bool( lft.get( ) )->value( ),
+                            objects::cast_bool( rght.get( ) )->value( ) );
+        }
+
+        static
+        objects::sptr char_num( infix *inf, const objects::sptr &lft,
+                                const objects::sptr &rght,
+                                const environment::sptr & )
+        {
+            return operation<objects::type::CHARACTER>::eval_int( inf,
+                            objects::cast_char( lft.get( ) )->value( ),
+                            to_int( rght.get( ) ) );
+        }
+
+        template <objects::type T>
+        static
+        objects::sptr str_str( infix *inf, const objects::sptr &lft,
+                               const objects::sptr &rght,
+                               const environment::sptr & )
+        {
+            return operation<T>::eval_str( inf,
+                            objects::cast<T>( lft.get( ) )->value( ),
+                            objects::cast<T>( rght.get( ) )->value( ) );
+        }
+
+        template <objects::type T>
+        static
+        objects::sptr str_int( infix *inf, const objects::sptr &lft,
+                               const objects::sptr &rght,
+                               const environment::sptr & )
+        {
+            return operation<T>::eval_int( inf,
+                            objects::cast<T>( lft.get( ) )->value( ),
+                            objects::cast_int( rght.get( ) )->value( ) );
+        }
+
+        /// the same pairs that operation<T>::eval_infix handles itself
+        void fill( tokens::type tt )
+        {
+            using OT = objects::type;
+
+            set( OT::INTEGER,   OT::INTEGER,   tt, &int_int );
+            set( OT::INTEGER,   OT::CHARACTER, tt, &int_int );
+            set( OT::INTEGER,   OT::BOOLEAN,   tt, &int_int );
+            set( OT::INTEGER,   OT::FLOAT,     tt, &num_float );
+
+            set( OT::FLOAT,     OT::INTEGER,   tt, &num_float );
+            set( OT::FLOAT,     OT::CHARACTER, tt, &num_float );
+            set( OT::FLOAT,     OT::FLOAT,     tt, &num_float );
+            set( OT::FLOAT,     OT::BOOLEAN,   tt, &num_float );
+
+            set( OT::BOOLEAN,   OT::INTEGER,   tt, &int_int );
+            set( OT::BOOLEAN,   OT::FLOAT,     tt, &num_float );
+            set( OT::BOOLEAN,   OT::BOOLEAN,   tt, &bool_bool );
+
+            set( OT::CHARACTER, OT::INTEGER,   tt, &char_num );
+            set( OT::CHARACTER, OT::FLOAT,     tt, &char_num );
+            set( OT::CHARACTER, OT::BOOLEAN,   tt, &char_num );
+
+            set( OT::STRING,    OT::STRING,    tt, &str_str<OT::STRING> );
+            set( OT::STRING,    OT::INTEGER,   tt, &str_int<OT::STRING> );
+            set( OT::RSTRING,   OT::RSTRING,   tt, &str_str<OT::RSTRING> );
+            set( OT::RSTRING,   OT::INTEGER,   tt, &str_int<OT::RSTRING> );
+        }
+
+        binary( )
+            :table_(types * types * slots, nullptr)
+            ,rows_(types * slots, 0)
+        {
+            auto first = static_cast<std::size_t>(tokens::type::MINUS);
+            for( std::size_t i = 0; i < row_slots; ++i ) {
+                auto tt = static_cast<tokens::type>( first + i );
+                if( slot( tt ) != npos ) {
+                    fill( tt );
+                }
+            }
+            fill( tokens::type::DOTDOT );
+            fill( tokens::type::OP_IN );
+        }
+
+        std::vector<function>     table_;
+        std::vector<std::uint8_t> rows_;
+    };
+
+}}}
+
+#endif // MICO_EVAL_BINARY_OPERATIONS_H
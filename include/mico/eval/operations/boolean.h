@@ -24,7 +24,7 @@ namespace mico { namespace eval { namespace operations {
         using infix         = ast::expressions::infix;
 
         static
-        objects::sptr eval_prefix( prefix *pref, objects::sptr obj )
+        objects::sptr eval_prefix( prefix *pref, const objects::sptr &obj )
         {
             common::reference<objects::type::BOOLEAN> ref(obj);
             auto val = ref.unref( )->value( );
@@ -81,8 +81,9 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<objects::type::BOOLEAN> ref(obj);
             auto val = ref.unref( )->value( );
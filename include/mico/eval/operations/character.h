@@ -34,7 +34,7 @@ namespace mico { namespace eval { namespace operations {
         static const objects::type bool_type_value = objects::type::BOOLEAN;
 
         static
-        objects::sptr eval_prefix( prefix *pref, objects::sptr obj )
+        objects::sptr eval_prefix( prefix *pref, const objects::sptr &obj )
         {
             common::reference<objects::type::CHARACTER> ref(obj);
 
@@ -122,23 +122,26 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_builtin( infix *inf,
-                                    objects::sptr obj, objects::sptr call,
-                                    environment::sptr env)
+                                    const objects::sptr &obj,
+                                    const objects::sptr &call,
+                                    const environment::sptr &env)
         {
             return common::eval_builtin( inf, obj, call, env );
         }
 
         static
         objects::sptr eval_func( infix *inf,
-                                 objects::sptr obj, objects::sptr call,
-                                 environment::sptr env)
+                                 const objects::sptr &obj,
+                                 const objects::sptr &call,
+                                 const environment::sptr &env)
         {
             return common::eval_func( inf, obj, call, env );
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<objects::type::CHARACTER> ref(obj);
             auto val = ref.unref( )->value( );
@@ -25,19 +25,22 @@ namespace mico { namespace eval { namespace operations {
         struct reference {
 
             using derive_type = objects::impl<T>;
-            using shared_derive = std::shared_ptr<derive_type>;
+            using shared_derive = mico::shared_ptr<derive_type>;
 
+            /// borrows 'o'; it must outlive the reference
             explicit
-            reference( objects::sptr o )
+            reference( const objects::sptr &o )
                 :value_(o)
             { }
 
+            reference( objects::sptr && ) = delete;
+
             objects::base *raw( )
             {
                 return value_.get( );
             }
 
-            objects::sptr shared_raw( )
+            const objects::sptr &shared_raw( )
             {
                 return value_;
             }
@@ -63,7 +66,7 @@ namespace mico { namespace eval { namespace operations {
             }
 
         private:
-            objects::sptr value_;
+            const objects::sptr &value_;
         };
 
 
@@ -127,7 +130,7 @@ namespace mico { namespace eval { namespace operations {
         static
         objects::sptr eval_ival_index( index *idx,
                                        typename TargetT::sptr tgt,
-                                       objects::sptr id )
+                                       const objects::sptr &id )
         {
             using target_type  = TargetT;
             using target_slice = typename target_type::slice_type;
@@ -188,8 +191,9 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_in_table( infix * /*inf*/,
-                                     objects::sptr lft, objects::sptr rght,
-                                     environment::sptr /*env*/  )
+                                     const objects::sptr &lft,
+                                     const objects::sptr &rght,
+                                     const environment::sptr &/*env*/  )
         {
             auto tbl = objects::cast_table( rght.get( ) );
             auto f = tbl->value( ).find( lft );
@@ -198,8 +202,9 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_in_array( infix * /*inf*/,
-                                     objects::sptr lft, objects::sptr rght,
-                                     environment::sptr /*env*/  )
+                                     const objects::sptr &lft,
+                                     const objects::sptr &rght,
+                                     const environment::sptr &/*env*/  )
         {
             using OB = objects::boolean;
             auto arr = objects::cast_array( rght.get( ) );
@@ -234,8 +239,9 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_in_ival( infix * /*inf*/,
-                                    objects::sptr lft, objects::sptr rght,
-                                    environment::sptr /*env*/  )
+                                    const objects::sptr &lft,
+                                    const objects::sptr &rght,
+                                    const environment::sptr &/*env*/  )
         {
             auto ivl = objects::cast_ival( rght.get( ) );
             switch (ivl->domain( )) {
@@ -265,8 +271,9 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr common_infix( infix *inf,
-                                    objects::sptr left, objects::sptr right,
-                                    environment::sptr env )
+                                    const objects::sptr &left,
+                                    const objects::sptr &right,
+                                    const environment::sptr &env )
 
         {
 
@@ -309,8 +316,9 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_builtin( infix * /*inf*/,
-                                    objects::sptr obj, objects::sptr call,
-                                    environment::sptr /*env*/ )
+                                    const objects::sptr &obj,
+                                    const objects::sptr &call,
+                                    const environment::sptr &/*env*/ )
         {
             objects::slist par { obj };
             auto func     = objects::cast_builtin(call.get( ));
@@ -320,7 +328,8 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_equal( infix *inf,
-                                  objects::sptr lft, objects::sptr rght )
+                                  const objects::sptr &lft,
+                                  const objects::sptr &rght )
         {
             if( lft->get_type( ) == rght->get_type( ) ) {
                 bool res = lft->equal( rght.get( ) );
@@ -338,8 +347,9 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_func( infix *inf,
-                                 objects::sptr obj, objects::sptr call,
-                                 environment::sptr /*env*/ )
+                                 const objects::sptr &obj,
+                                 const objects::sptr &call,
+                                 const environment::sptr &/*env*/ )
         {
             auto func = objects::cast_func(call.get( ));
             auto call_env = environment::make( func->env( ) );
@@ -376,21 +386,22 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
-            obj = objects::reference::unref( obj );
+            auto val = objects::reference::unref( obj );
 
             if( inf->token( ) == tokens::type::BIT_OR ) {
                 objects::sptr right = ev( inf->right( ).get( ), env );
                 if( common::is_fail( right ) ) {
                     return right;
                 }
-                return common_infix( inf, obj, right, env );
+                return common_infix( inf, val, right, env );
             }
             return error_type::make(inf->pos( ), "Infix operation '",
                                     inf->token( ), "' is not defined for ",
-                                                   obj->get_type( ));
+                                                   val->get_type( ));
         }
 
     };
@@ -24,22 +24,24 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_builtin( infix *inf,
-                                    objects::sptr obj, objects::sptr call,
-                                    environment::sptr env)
+                                    const objects::sptr &obj,
+                                    const objects::sptr &call,
+                                    const environment::sptr &env)
         {
             return common::eval_builtin( inf, obj, call, env );
         }
 
         static
         objects::sptr eval_func( infix *inf,
-                                 objects::sptr obj, objects::sptr call,
-                                 environment::sptr env)
+                                 const objects::sptr &obj,
+                                 const objects::sptr &call,
+                                 const environment::sptr &env)
         {
             return common::eval_func( inf, obj, call, env );
         }
 
         static
-        objects::sptr eval_prefix( prefix *pref, objects::sptr obj )
+        objects::sptr eval_prefix( prefix *pref, const objects::sptr &obj )
         {
             common::reference<objects::type::FLOAT> ref(obj);
             auto val = ref.unref( )->value( );
@@ -65,8 +67,9 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<objects::type::FLOAT> ref(obj);
 
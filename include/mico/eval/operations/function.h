@@ -14,7 +14,7 @@ namespace mico { namespace eval { namespace operations {
         using call_type  = ast::expressions::call;
 
         static
-        objects::sptr eval_prefix( prefix *pref, objects::sptr obj )
+        objects::sptr eval_prefix( prefix *pref, const objects::sptr &obj )
         {
             if( pref->token( ) == tokens::type::ASTERISK ) {
                 auto unref = objects::reference::unref( obj );
@@ -32,10 +32,11 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &left,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
-            obj = objects::reference::unref( obj );
+            auto obj = objects::reference::unref( left );
 
             if( inf->token( ) == tokens::type::BIT_OR ) {
                 objects::sptr right = ev( inf->right( ).get( ), env );
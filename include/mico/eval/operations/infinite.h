@@ -22,7 +22,7 @@ namespace mico { namespace eval { namespace operations {
         using infix  = ast::expressions::infix;
 
         static
-        objects::sptr eval_prefix( prefix *pref, objects::sptr obj )
+        objects::sptr eval_prefix( prefix *pref, const objects::sptr &obj )
         {
             common::reference<objects::type::INF_OBJ> ref(obj);
             auto val = ref.unref( );
@@ -39,8 +39,9 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             return common::eval_infix( inf, obj, ev, env );
         }
@@ -19,8 +19,8 @@ namespace mico { namespace eval { namespace operations {
 
         using eval_function_call = std::function<objects::sptr
                                     (ast::expressions::call *,
-                                     objects::sptr ,
-                                     environment::sptr)>;
+                                     const objects::sptr &,
+                                     const environment::sptr &)>;
 
 //        static
 //        objects::sptr eval_prefix( tokens::type, objects::sptr )
@@ -30,7 +30,8 @@ namespace mico { namespace eval { namespace operations {
 
         static
         objects::sptr eval_call_param( infix *inf, objects::module::sptr mod,
-                                 eval_function_call ev, environment::sptr env )
+                                 const eval_function_call &ev,
+                                 const environment::sptr &env )
         {
             using call_type = ast::expressions::call;
             auto call = ast::cast<call_type>( inf->right( ).get( ) );
@@ -53,8 +54,9 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_function_call ev, environment::sptr env )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &obj,
+                                  const eval_function_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<objects::type::MODULE> ref(obj);
             auto mod = ref.shared_unref( );
@@ -21,14 +21,15 @@ namespace mico { namespace eval { namespace operations {
         static
         objects::sptr eval_ival_index( index *idx,
                                        value_type str,
-                                       objects::sptr id )
+                                       const objects::sptr &id )
         {
             return common::eval_ival_index<object_type>(idx, str, id);
         }
 
         static
-        objects::sptr eval_index( index *idx, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_index( index *idx, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<TN> ref(obj);
             auto str = ref.shared_unref( );
@@ -73,14 +74,15 @@ namespace mico { namespace eval { namespace operations {
         static
         objects::sptr eval_ival_index( index *idx,
                                        objects::aslice::sptr str,
-                                       objects::sptr id )
+                                       const objects::sptr &id )
         {
             return parent_type::eval_ival_index(idx, str, id);
         }
 
         static
-        objects::sptr eval_index( index *idx, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_index( index *idx, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             return parent_type::eval_index( idx, obj, ev, env );
         }
@@ -98,14 +100,15 @@ namespace mico { namespace eval { namespace operations {
         static
         objects::sptr eval_ival_index( index *idx,
                                        objects::sslice::sptr str,
-                                       objects::sptr id )
+                                       const objects::sptr &id )
         {
             return parent_type::eval_ival_index( idx, str, id );
         }
 
         static
-        objects::sptr eval_index( index *idx, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_index( index *idx, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             return parent_type::eval_index( idx, obj, ev, env );
         }
@@ -123,14 +126,15 @@ namespace mico { namespace eval { namespace operations {
         static
         objects::sptr eval_ival_index( index *idx,
                                        objects::rslice::sptr str,
-                                       objects::sptr id )
+                                       const objects::sptr &id )
         {
             return parent_type::eval_ival_index( idx, str, id );
         }
 
         static
-        objects::sptr eval_index( index *idx, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_index( index *idx, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             return parent_type::eval_index( idx, obj, ev, env );
         }
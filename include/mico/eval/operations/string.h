@@ -22,7 +22,7 @@ namespace mico { namespace eval { namespace operations {
         using string_type   = objects::string::value_type;
 
         static
-        objects::sptr eval_prefix( prefix *pref, objects::sptr /*obj*/ )
+        objects::sptr eval_prefix( prefix *pref, const objects::sptr &/*obj*/ )
         {
             return error_type::make(pref->pos( ), "Prefix operator '",
                                     pref->token( ), "' is not defined for "
@@ -86,14 +86,15 @@ namespace mico { namespace eval { namespace operations {
         static
         objects::sptr eval_ival_index( index *idx,
                                        objects::string::sptr str,
-                                       objects::sptr id )
+                                       const objects::sptr &id )
         {
             return common::eval_ival_index<objects::string>(idx, str, id);
         }
 
         static
-        objects::sptr eval_index( index *idx, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_index( index *idx, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<objects::type::STRING> ref(obj);
             auto str = ref.shared_unref( );
@@ -136,8 +137,9 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<objects::type::STRING> ref(obj);
             auto val = ref.unref( );
@@ -19,7 +19,7 @@ namespace mico { namespace eval { namespace operations {
         using index      = ast::expressions::index;
 
         static
-        objects::sptr eval_prefix( prefix *pref, objects::sptr obj )
+        objects::sptr eval_prefix( prefix *pref, const objects::sptr &obj )
         {
             common::reference<objects::type::TABLE> ref(obj);
             auto tt = ref.unref( );
@@ -33,8 +33,9 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_table( environment::sptr env,
-                                  objects::sptr lft, objects::sptr rght )
+        objects::sptr eval_table( const environment::sptr &env,
+                                  const objects::sptr &lft,
+                                  const objects::sptr &rght )
         {
             auto ltable = objects::cast_table(lft);
             auto rtable = objects::cast_table(rght);
@@ -50,8 +51,9 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_index( index *idx, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_index( index *idx, const objects::sptr &obj,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
             common::reference<objects::type::TABLE> ref(obj);
             auto tab = ref.shared_unref( );
@@ -72,11 +74,12 @@ namespace mico { namespace eval { namespace operations {
         }
 
         static
-        objects::sptr eval_infix( infix *inf, objects::sptr obj,
-                                  eval_call ev, environment::sptr env  )
+        objects::sptr eval_infix( infix *inf, const objects::sptr &left,
+                                  const eval_call &ev,
+                                  const environment::sptr &env )
         {
-            common::reference<objects::type::TABLE> ref(obj);
-            obj = ref.shared_unref( );
+            common::reference<objects::type::TABLE> ref(left);
+            objects::sptr obj = ref.shared_unref( );
 
             objects::sptr right = ev( inf->right( ).get( ), env );
             if( common::is_fail( right ) ) {
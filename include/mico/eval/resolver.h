@@ -0,0 +1,315 @@
+#ifndef MICO_EVAL_RESOLVER_H
+#define MICO_EVAL_RESOLVER_H
+
+#include <vector>
+
+#include "mico/ast.h"
+#include "mico/layout.h"
+#include "mico/expressions.h"
+#include "mico/statements.h"
+
+namespace mico { namespace eval {
+
+    /// Binds identifiers to (depth, slot) coordinates.
+    /// Every environment that the evaluator creates for a function call,
+    /// an if branch or a for iteration gets the layout of its body, so a
+    /// resolved identifier is found without the name lookup.
+    /// The global scope, modules and scopes with quote/unquote can get
+    /// names at runtime; lookups that pass them stay dynamic.
+    class resolver {
+
+        struct frame {
+            layout::sptr lay;
+            bool         dynamic;
+        };
+
+        using ident    = ast::expressions::ident;
+        using list     = ast::expressions::list;
+        using function = ast::expressions::function;
+        using elipsis  = ast::expressions::elipsis;
+
+        static
+        list *as_scope( ast::node *n )
+        {
+            if( n && n->get_type( ) == ast::type::LIST ) {
+                return ast::cast<list>( n );
+            }
+            return nullptr;
+        }
+
+        template <typename NodeT>
+        static
+        void for_each( NodeT *n, std::function<void (ast::node *)> call )
+        {
+            n->mutate( [&call]( ast::node *c ) {
+                call( c );
+                return ast::node::uptr( );
+            } );
+        }
+
+        /// names that are bound in the current environment by 'n'
+        static
+        void collect( ast::node *n, layout &lay, bool &dynamic )
+        {
+            if( !n ) {
+                return;
+            }
+            auto chld = [&lay, &dynamic]( ast::node *c ) {
+                collect( c, lay, dynamic );
+            };
+            switch( n->get_type( ) ) {
+            case ast::type::LET: {
+                auto let = ast::cast<ast::statements::let>( n );
+                if( let->ident( )->get_type( ) == ast::type::IDENT ) {
+                    lay.add( ast::cast<ident>( let->ident( ).get( ) )
+                                                            ->value( ) );
+                }
+                collect( let->value( ).get( ), lay, dynamic );
+                break;
+            }
+            case ast::type::FN: {
+                /// inits are set in the environment of the literal
+                auto func = ast::cast<function>( n );
+                for( auto &i: func->inits( ) ) {
+                    lay.add( i.first );
+                    collect( i.second.get( ), lay, dynamic );
+                }
+                break;
+            }
+            case ast::type::IFELSE: {
+                auto ifblock = ast::cast<ast::expressions::ifelse>( n );
+                for( auto &i: ifblock->ifs( ) ) {
+                    collect( i.cond.get( ), lay, dynamic );
+                }
+                break;
+            }
+            case ast::type::FORIN: {
+                auto fori = ast::cast<ast::expressions::forin>( n );
+                for_each( fori->expres( ).get( ), chld );
+                break;
+            }
+            case ast::type::MODULE: {
+                auto mod = ast::cast<ast::expressions::mod>( n );
+                for( auto &p: mod->parents( ) ) {
+                    collect( p.get( ), lay, dynamic );
+                }
+                break;
+            }
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+            case ast::type::QUOTE:
+            case ast::type::UNQUOTE:
+                dynamic = true;
+                break;
+            case ast::type::MACRO:
+                break;
+#endif
+            default:
+                for_each( n, chld );
+                break;
+            }
+        }
+
+        void resolve( ident *id )
+        {
+            std::size_t depth = 0;
+            for( auto f = frames_.rbegin( ); f != frames_.rend( ); ++f ) {
+                if( f->lay ) {
+                    auto slot = f->lay->find( id->value( ) );
+                    if( slot != layout::npos ) {
+                        id->resolve( depth, slot, f->lay );
+                        return;
+                    }
+                }
+                if( f->dynamic ) {
+                    return;
+                }
+                ++depth;
+            }
+        }
+
+        /// 'id' is bound in the current environment
+        void bind( ident *id )
+        {
+            auto &lay( frames_.back( ).lay );
+            if( lay ) {
+                auto slot = lay->find( id->value( ) );
+                if( slot != layout::npos ) {
+                    id->resolve( 0, slot, lay );
+                }
+            }
+        }
+
+        /// a body that is not parsed yet is resolved after the parsing
+        /// with the frames that are seen here
+        void scope_lazy( ast::expressions::lazy *body, layout::sptr lay )
+        {
+            if( body->ready( ) ) {
+                scope( body->get( ).get( ), lay );
+                return;
+            }
+            auto frames = frames_;
+            body->defer( [frames, lay]( ast::node::uptr &n,
+                                        std::vector<std::string> & ) {
+                resolver res;
+                res.frames_ = frames;
+                res.scope( n.get( ), lay );
+            } );
+        }
+
+        /// 'body' is evaluated in a new environment that already has 'lay'
+        void scope( ast::node *body, layout::sptr lay )
+        {
+            if( body && body->get_type( ) == ast::type::LAZY ) {
+                scope_lazy( ast::cast<ast::expressions::lazy>( body ), lay );
+                return;
+            }
+            auto scp = as_scope( body );
+            if( !scp ) {
+                frames_.push_back( frame { nullptr, true } );
+                walk( body );
+                frames_.pop_back( );
+                return;
+            }
+            bool dynamic = false;
+            for( auto &s: scp->value( ) ) {
+                collect( s.get( ), *lay, dynamic );
+            }
+            scp->set_layout( lay );
+            frames_.push_back( frame { lay, dynamic } );
+            for( auto &s: scp->value( ) ) {
+                walk( s.get( ) );
+            }
+            frames_.pop_back( );
+        }
+
+        void walk_function( function *func )
+        {
+            for( auto &i: func->inits( ) ) {
+                walk( i.second.get( ) );
+            }
+
+            auto lay = layout::make( );
+            for( auto &p: func->params( )->value( ) ) {
+                if( p->get_type( ) == ast::type::IDENT ) {
+                    auto id = ast::cast<ident>( p.get( ) );
+                    id->resolve( 0, lay->add( id->value( ) ), lay );
+                } else if( p->get_type( ) == ast::type::ELIPSIS ) {
+                    auto eli = ast::cast<elipsis>( p.get( ) );
+                    lay->add( eli->is_ident( )
+                            ? ast::cast<ident>( eli->value( ).get( ) )->value( )
+                            : "__args" );
+                }
+            }
+
+            /// the closure has its own empty environment
+            frames_.push_back( frame { nullptr, false } );
+            scope( func->body( ).get( ), lay );
+            frames_.pop_back( );
+        }
+
+        void walk_infix( ast::expressions::infix *inf )
+        {
+            walk( inf->left( ).get( ) );
+            if( inf->token( ) != tokens::type::DOT ) {
+                walk( inf->right( ).get( ) );
+                return;
+            }
+            /// module members are not variables
+            auto right = inf->right( ).get( );
+            if( right->get_type( ) == ast::type::CALL ) {
+                auto call = ast::cast<ast::expressions::call>( right );
+                for( auto &p: call->param_list( ) ) {
+                    walk( p.get( ) );
+                }
+            } else if( right->get_type( ) != ast::type::IDENT ) {
+                walk( right );
+            }
+        }
+
+        void walk( ast::node *n )
+        {
+            if( !n ) {
+                return;
+            }
+            switch( n->get_type( ) ) {
+            case ast::type::IDENT:
+                resolve( ast::cast<ident>( n ) );
+                break;
+            case ast::type::LET: {
+                auto let = ast::cast<ast::statements::let>( n );
+                walk( let->value( ).get( ) );
+                if( let->ident( )->get_type( ) == ast::type::IDENT ) {
+                    bind( ast::cast<ident>( let->ident( ).get( ) ) );
+                }
+                break;
+            }
+            case ast::type::INFIX:
+                walk_infix( ast::cast<ast::expressions::infix>( n ) );
+                break;
+            case ast::type::FN:
+                walk_function( ast::cast<function>( n ) );
+                break;
+            case ast::type::IFELSE: {
+                auto ifblock = ast::cast<ast::expressions::ifelse>( n );
+                for( auto &i: ifblock->ifs( ) ) {
+                    walk( i.cond.get( ) );
+                    scope( i.body.get( ), layout::make( ) );
+                }
+                if( ifblock->alt( ) ) {
+                    scope( ifblock->alt( ).get( ), layout::make( ) );
+                }
+                break;
+            }
+            case ast::type::FORIN: {
+                auto fori = ast::cast<ast::expressions::forin>( n );
+                for( auto &e: fori->expres( )->value( ) ) {
+                    walk( e.get( ) );
+                }
+                auto lay = layout::make( );
+                for( auto &i: fori->idents( )->value( ) ) {
+                    lay->add( i->get_type( ) == ast::type::IDENT
+                            ? ast::cast<ident>( i.get( ) )->value( )
+                            : i->str( ) );
+                }
+                scope( fori->body( ).get( ), lay );
+                break;
+            }
+            case ast::type::MODULE: {
+                auto mod = ast::cast<ast::expressions::mod>( n );
+                for( auto &p: mod->parents( ) ) {
+                    walk( p.get( ) );
+                }
+                frames_.push_back( frame { nullptr, true } );
+                walk( mod->body( ).get( ) );
+                frames_.pop_back( );
+                break;
+            }
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+            case ast::type::QUOTE:
+            case ast::type::UNQUOTE:
+            case ast::type::MACRO:
+                break;
+#endif
+            default:
+                for_each( n, [this]( ast::node *c ) { walk( c ); } );
+                break;
+            }
+        }
+
+        std::vector<frame> frames_;
+
+    public:
+
+        /// 'n' is evaluated in an environment that can get any name
+        static
+        void process( ast::node *n )
+        {
+            resolver res;
+            res.frames_.push_back( frame { nullptr, true } );
+            res.walk( n );
+        }
+    };
+
+}}
+
+#endif // MICO_EVAL_RESOLVER_H
@@ -22,6 +22,7 @@
 #include "mico/eval/operations/slices.h"
 #include "mico/eval/operations/infinite.h"
 #include "mico/eval/operations/character.h"
+#include "mico/eval/operations/binary.h"
 
 #include "mico/charset/encoding.h"
 
@@ -38,7 +39,7 @@ namespace mico { namespace eval {
         ~tree_walking( )
         { }
 
-    private:
+    protected:
 
         template <objects::type T>
         using OP  = operations::operation<T>;
@@ -177,13 +178,64 @@ namespace mico { namespace eval {
         static
         objects::sptr unref( objects::sptr obj )
         {
-            return objects::reference::unref( obj );
+            return objects::reference::unref( std::move(obj) );
         }
 
         static
-        environment::sptr make_env( environment::sptr parent )
+        environment::sptr make_env( environment::sptr parent,
+                                    layout::sptr lay = layout::sptr( ) )
         {
-            return environment::make(parent);
+            return environment::make( parent, std::move(lay) );
+        }
+
+        /// the layout that the resolver gave to a body
+        static
+        layout::sptr scope_layout( const ast::node *n )
+        {
+            if( n && n->get_type( ) == ast::type::LAZY ) {
+                using lazy = ast::expressions::lazy;
+                n = static_cast<const lazy *>( n )->get( ).get( );
+            }
+            if( n && n->get_type( ) == ast::type::LIST ) {
+                using list = ast::expressions::list;
+                return static_cast<const list *>( n )->get_layout( );
+            }
+            return layout::sptr( );
+        }
+
+        /// 'id' is a name that is bound in 'env' itself
+        static
+        void bind( environment *env, const ast::expressions::ident *id,
+                   objects::sptr val, bool var )
+        {
+            if( id->is_resolved( )
+             && env->set( id->slot( ), id->owner( ), val, var ) ) {
+                return;
+            }
+            if( var ) {
+                env->set( id->value( ), std::move(val) );
+            } else {
+                env->set_const( id->value( ), std::move(val) );
+            }
+        }
+
+        /// a variable is returned as a reference only if 'ref' is set
+        static
+        objects::sptr lookup( const ast::expressions::ident *id,
+                              environment *env, bool ref )
+        {
+            objects::sptr val;
+            if( id->is_resolved( ) ) {
+                val = ref ? env->get( id->depth( ), id->slot( ),
+                                      id->owner( ) )
+                          : env->get_value( id->depth( ), id->slot( ),
+                                            id->owner( ) );
+            }
+            if( !val ) {
+                val = ref ? env->get( id->value( ) )
+                          : env->get_value( id->value( ) );
+            }
+            return val;
         }
 
         objects::boolean::sptr get_bool( const ast::node *n )
@@ -192,10 +244,16 @@ namespace mico { namespace eval {
             return get_bool_value(bstate->value( ));
         }
 
-        objects::integer::sptr eval_int( ast::node *n )
+        /// literals make their objects once, see 'literal_object'
+        objects::sptr eval_int( ast::node *n )
         {
             auto state = ast::cast<ast::expressions::integer>(n);
-            return std::make_shared<objects::integer>( state->value( ) );
+            if( auto &obj = state->object( ) ) {
+                return obj;
+            }
+            objects::sptr res = objects::integer::make( state->value( ) );
+            state->set_object( res );
+            return res;
         }
 
         objects::sptr extract_return( objects::sptr obj )
@@ -211,27 +269,44 @@ namespace mico { namespace eval {
         objects::sptr eval_float( ast::node *n )
         {
             auto state = ast::cast<ast::expressions::floating>(n);
-            return std::make_shared<objects::floating>( state->value( ) );
+            if( auto &obj = state->object( ) ) {
+                return obj;
+            }
+            objects::sptr res = objects::floating::make( state->value( ) );
+            state->set_object( res );
+            return res;
         }
 
+        /// the string is decoded once
         objects::sptr eval_string( ast::node *n )
         {
             auto val = ast::cast<ast::expressions::string>(n);
+            if( auto &obj = val->object( ) ) {
+                return obj;
+            }
+            objects::sptr res;
             if( val->is_raw( ) ) {
-                return objects::rstring::make( val->value( ) );
+                res = objects::rstring::make( val->value( ) );
             } else {
                 auto int_str = charset::encoding::from_file( val->value( ) );
-                return objects::string::make( std::move(int_str) );
+                res = objects::string::make( std::move(int_str) );
             }
+            val->set_object( res );
+            return res;
         }
 
-        objects::character::sptr eval_charset( ast::node *n )
+        objects::sptr eval_charset( ast::node *n )
         {
             auto val = ast::cast<ast::expressions::character>(n);
-            return objects::character::make( val->value( ) );
+            if( auto &obj = val->object( ) ) {
+                return obj;
+            }
+            objects::sptr res = objects::character::make( val->value( ) );
+            val->set_object( res );
+            return res;
         }
 
-        objects::sptr eval_prefix( ast::node *n, environment::sptr env )
+        objects::sptr eval_prefix( ast::node *n, const environment::sptr &env )
         {
             auto expr = ast::cast<ast::expressions::prefix>( n );
             auto oper = eval_impl(expr->value( ).get( ), env);
@@ -240,6 +315,26 @@ namespace mico { namespace eval {
                 return oper;
             }
 
+            return eval_prefix_obj( expr, oper );
+        }
+
+        static
+        ast::quick prefix_kind( objects::type tt )
+        {
+            switch( tt ) {
+            case objects::type::INTEGER:
+                return ast::quick::INTEGER;
+            case objects::type::FLOAT:
+                return ast::quick::FLOAT;
+            case objects::type::BOOLEAN:
+                return ast::quick::BOOLEAN;
+            }
+            return ast::quick::GENERIC;
+        }
+
+        objects::sptr eval_prefix_obj( ast::expressions::prefix *expr,
+                                       const objects::sptr &oper )
+        {
             using OP_int   = OP<objects::type::INTEGER>;
             using OP_float = OP<objects::type::FLOAT>;
             using OP_bool  = OP<objects::type::BOOLEAN>;
@@ -252,6 +347,23 @@ namespace mico { namespace eval {
             using OP_char  = OP<objects::type::CHARACTER>;
 
             objects::type opertype = oper->get_type( );
+
+            /// the node has seen only plain values of this type
+            auto kind = prefix_kind( opertype );
+            if( kind == expr->quick_kind( ) ) {
+                switch( kind ) {
+                case ast::quick::INTEGER:
+                    return OP_int::eval_prefix(expr, oper);
+                case ast::quick::FLOAT:
+                    return OP_float::eval_prefix(expr, oper);
+                case ast::quick::BOOLEAN:
+                    return OP_bool::eval_prefix(expr, oper);
+                }
+            } else if( expr->quick_kind( ) != ast::quick::GENERIC ) {
+                expr->set_quick( expr->quick_kind( ) == ast::quick::UNKNOWN
+                                 ? kind : ast::quick::GENERIC );
+            }
+
             if( opertype == objects::type::REFERENCE ) {
                 opertype = objects::cast_ref( oper )->value( )->get_type( );
             }
@@ -282,7 +394,7 @@ namespace mico { namespace eval {
                 break;
             }
 
-            return error( n, "Invalid prefix function '",
+            return error( expr, "Invalid prefix function '",
                           expr->token( ), "' for ",
                           expr->value( )->get_type( ) );
         }
@@ -330,10 +442,39 @@ namespace mico { namespace eval {
             return get_null( );
         }
 
-        objects::sptr eval_assign( ast::expressions::infix *inf,
-                                   environment::sptr env )
+        /// the value that an assignment stores; scalars are never changed
+        /// while somebody else holds them and need no copy
+        static
+        objects::sptr assign_copy( const objects::sptr &val )
         {
-            auto lft = eval_impl_tail( inf->left( ).get( ), env );
+            switch( val->get_type( ) ) {
+            case objects::type::NULL_OBJ:
+            case objects::type::BOOLEAN:
+            case objects::type::INTEGER:
+            case objects::type::FLOAT:
+            case objects::type::CHARACTER:
+                return val;
+            default:
+                break;
+            }
+            return val->clone( );
+        }
+
+        objects::sptr eval_assign( ast::expressions::infix *inf,
+                                   const environment::sptr &env )
+        {
+            auto left = inf->left( ).get( );
+            objects::sptr lft;
+            if( left->get_type( ) == ast::type::IDENT ) {
+                auto id = ast::cast<ast::expressions::ident>( left );
+                lft = lookup( id, env.get( ), true );
+                if( !lft ) {
+                    return error( left, "Identifier not found '",
+                                  left->str( ), "'" );
+                }
+            } else {
+                lft = eval_impl_tail( left, env );
+            }
             if( lft->get_type( ) == objects::type::REFERENCE ) {
                 auto cont = objects::cast_ref(lft.get( ));
                 auto rght = unref(eval_impl_tail(inf->right( ).get( ),
@@ -341,14 +482,159 @@ namespace mico { namespace eval {
                 if( is_fail( rght ) ) {
                     return rght;
                 }
-                cont->set_value(env.get( ), rght->clone( ));
+                cont->set_value(env.get( ), assign_copy( rght ));
                 return cont->value( );
             }
             return error( inf, "Invalid left value for ASSIGN ",
                           inf->left( ).get( ) );
         }
 
-        objects::sptr eval_infix( ast::node *n, environment::sptr env )
+        /// the kind of operands that 'tt' can be specialized on
+        static
+        ast::quick infix_kind( tokens::type tt, const objects::base *left )
+        {
+            using TT = tokens::type;
+            switch( left->get_type( ) ) {
+            case objects::type::INTEGER:
+                switch( tt ) {
+                case TT::MINUS:      case TT::PLUS:        case TT::ASTERISK:
+                case TT::SLASH:      case TT::PERCENT:
+                case TT::SHIFT_LEFT: case TT::SHIFT_RIGHT:
+                case TT::BIT_AND:    case TT::BIT_OR:      case TT::BIT_XOR:
+                case TT::GT:         case TT::LT:
+                case TT::GT_EQ:      case TT::LT_EQ:
+                case TT::EQ:         case TT::NOT_EQ:
+                    return ast::quick::INTEGER;
+                }
+                break;
+            case objects::type::FLOAT:
+                switch( tt ) {
+                case TT::MINUS:      case TT::PLUS:        case TT::ASTERISK:
+                case TT::SLASH:
+                case TT::GT:         case TT::LT:
+                case TT::GT_EQ:      case TT::LT_EQ:
+                case TT::EQ:         case TT::NOT_EQ:
+                    return ast::quick::FLOAT;
+                }
+                break;
+            case objects::type::STRING:
+                switch( tt ) {
+                case TT::PLUS:
+                case TT::GT:         case TT::LT:
+                case TT::GT_EQ:      case TT::LT_EQ:
+                case TT::EQ:         case TT::NOT_EQ:
+                    return ast::quick::STRING;
+                }
+                break;
+            }
+            return ast::quick::GENERIC;
+        }
+
+        /// int x int, float x float and string x string go straight to
+        /// the operation while 'inf' sees nothing else.
+        /// Returns nullptr when 'left' is not what the node expects;
+        /// the node is generic from now on.
+        static
+        objects::sptr eval_num( ast::expressions::infix *inf,
+                                std::int64_t lft, std::int64_t rgh )
+        {
+            return OP<objects::type::INTEGER>::eval_int( inf, lft, rgh );
+        }
+
+        static
+        objects::sptr eval_num( ast::expressions::infix *inf,
+                                double lft, double rgh )
+        {
+            return OP<objects::type::FLOAT>::eval_float( inf, lft, rgh );
+        }
+
+        /// two numbers of one kind. '+', '-' and '*' put the result into
+        /// an operand that nobody else holds, a temporary of a longer
+        /// expression, instead of a new number
+        template <objects::type TN>
+        static
+        objects::sptr eval_num_tmp( ast::expressions::infix *inf,
+                                    const objects::sptr &left,
+                                    const objects::sptr &right )
+        {
+            using num_type = objects::impl<TN>;
+            auto lft = static_cast<const num_type *>( left.get( ) )->value( );
+            auto rgh = static_cast<const num_type *>( right.get( ) )->value( );
+            typename num_type::value_type res;
+            switch( inf->token( ) ) {
+            case tokens::type::PLUS:
+                res = lft + rgh;
+                break;
+            case tokens::type::MINUS:
+                res = lft - rgh;
+                break;
+            case tokens::type::ASTERISK:
+                res = lft * rgh;
+                break;
+            default:
+                return eval_num( inf, lft, rgh );
+            }
+            return num_type::reuse( left.use_count( ) == 1 ? left : right,
+                                    res );
+        }
+
+        objects::sptr eval_infix_quick( ast::expressions::infix *inf,
+                                        const objects::sptr &left,
+                                        const environment::sptr &env )
+        {
+            auto kind = infix_kind( inf->token( ), left.get( ) );
+            auto seen = inf->quick_kind( );
+            if( ( kind == ast::quick::GENERIC ) ||
+                ( seen != ast::quick::UNKNOWN && seen != kind ) ) {
+                inf->set_quick( ast::quick::GENERIC );
+                return nullptr;
+            }
+
+            auto right = unref( eval_impl_tail( inf->right( ).get( ), env ) );
+            if( is_fail( right ) ) {
+                return right;
+            }
+
+            if( right->get_type( ) != left->get_type( ) ) {
+                inf->set_quick( ast::quick::GENERIC );
+                return eval_binary( inf, left, right, env );
+            }
+
+            inf->set_quick( kind );
+            switch( kind ) {
+            case ast::quick::INTEGER:
+                return eval_num_tmp<objects::type::INTEGER>( inf, left,
+                                                             right );
+            case ast::quick::FLOAT:
+                return eval_num_tmp<objects::type::FLOAT>( inf, left, right );
+            default:
+                return OP<objects::type::STRING>::eval_str( inf,
+                             objects::cast_string( left.get( ) )->value( ),
+                             objects::cast_string( right.get( ) )->value( ) );
+            }
+        }
+
+        /// both operands are ready; the dispatch table first
+        objects::sptr eval_binary( ast::expressions::infix *inf,
+                                   const objects::sptr &left,
+                                   const objects::sptr &right,
+                                   const environment::sptr &env )
+        {
+            auto &ops( operations::binary::instance( ) );
+            auto call = ops.get( left->get_type( ), right->get_type( ),
+                                 inf->token( ) );
+            if( call ) {
+                return eval_tail( call( inf, left, right, env ) );
+            }
+            auto ready = [&right]( ast::node *, const environment::sptr & ) {
+                return right;
+            };
+            auto res = eval_infix_obj( inf, left, ready, env );
+            return res ? eval_tail( std::move(res) )
+                       : error_operation_notfound( inf->token( ), inf );
+        }
+
+        objects::sptr eval_infix( ast::node *n, const environment::sptr &env )
         {
             auto inf = ast::cast<ast::expressions::infix>(n);
 
@@ -363,12 +649,27 @@ namespace mico { namespace eval {
                 return left;
             }
 
-            objects::type opertype = left->get_type( );
-            if( opertype == objects::type::REFERENCE ) {
-                opertype = objects::cast_ref( left )->value( )->get_type( );
+            if( inf->quick_kind( ) != ast::quick::GENERIC ) {
+                if( auto res = eval_infix_quick( inf, left, env ) ) {
+                    return res;
+                }
             }
 
-            auto inf_call_unref = [this](ast::node *n, environment::sptr env ) {
+            state::temp_roots held( env->get_state( ) );
+            held.add( left );
+
+            auto &ops( operations::binary::instance( ) );
+            if( ops.has( left->get_type( ), inf->token( ) ) ) {
+                auto right = unref( eval_impl_tail( inf->right( ).get( ),
+                                                    env ) );
+                if( is_fail( right ) ) {
+                    return right;
+                }
+                return eval_binary( inf, left, right, env );
+            }
+
+            auto inf_call_unref = [this]( ast::node *n,
+                                          const environment::sptr &env ) {
                 return unref( eval_impl_tail( n, env ) );
             };
 
@@ -376,9 +677,28 @@ namespace mico { namespace eval {
 //                return unref(eval_impl_tail( n, env ));
 //            };
 
+            auto res = eval_infix_obj( inf, left, inf_call_unref, env );
+            if( res ) {
+                return eval_tail( std::move(res) );
+            }
+
+            return error_operation_notfound( inf->token( ), inf );
+        }
+
+        /// 'left' is already evaluated; 'inf_call_unref' evaluates the right
+        objects::sptr eval_infix_obj( ast::expressions::infix *inf,
+                                const objects::sptr &left,
+                                const operations::eval_call &inf_call_unref,
+                                const environment::sptr &env )
+        {
+            objects::type opertype = left->get_type( );
+            if( opertype == objects::type::REFERENCE ) {
+                opertype = objects::cast_ref( left )->value( )->get_type( );
+            }
+
             auto func_call = [this](ast::expressions::call *n,
-                                    objects::sptr func,
-                                    environment::sptr env )
+                                    const objects::sptr &func,
+                                    const environment::sptr &env )
             {
                 return eval_call_obj( n, func, env );
             };
@@ -434,16 +754,12 @@ namespace mico { namespace eval {
             default:
                 res = OPC::eval_infix( inf, left, inf_call_unref, env);
             }
-            if( res ) {
-                return eval_tail( res );
-            }
-
-            return error_operation_notfound( inf->token( ), inf );
+            return res;
         }
 
         environment::sptr create_call_env( ast::expressions::call *call,
                                            objects::base *fun,
-                                           environment::sptr env,
+                                           const environment::sptr &env,
                                            objects::slist &params )
         {
             //// TODO bug with built in funcions!
@@ -456,7 +772,8 @@ namespace mico { namespace eval {
 
                 auto vfun = objects::cast_func(fun);
 
-                auto new_env = environment::make(vfun->env( ));
+                auto new_env = environment::make( vfun->env( ),
+                                            scope_layout( vfun->body( ) ) );
                 auto new_args = objects::array::make( new_env );
 
                 size_t id = 0;
@@ -468,7 +785,7 @@ namespace mico { namespace eval {
                         auto v = unref( eval_impl_tail(
                                         call->param_at(id++).get( ), env ) );
 
-                        new_env->set( n->value( ), v );
+                        bind( new_env.get( ), n, v, true );
 
                     } else if( p->get_type( ) == ast::type::ELIPSIS ) {
                         auto eli = ast::cast<elipsis>( p.get( ) );
@@ -500,8 +817,10 @@ namespace mico { namespace eval {
                 auto vfun = objects::cast_builtin(fun);
                 auto new_env = environment::make(vfun->env( ));
 
+                state::temp_roots held( env->get_state( ) );
                 for( auto &cp: call->param_list( ) ) {
                     auto v = unref( eval_impl_tail( cp.get( ), env ) );
+                    held.add( v );
                     params.push_back( v );
                 }
                 return new_env;
@@ -509,7 +828,8 @@ namespace mico { namespace eval {
             return env;
         }
 
-        objects::sptr create_tail_call( ast::node *n, environment::sptr env )
+        objects::sptr create_tail_call( ast::node *n,
+                                        const environment::sptr &env )
         {
 
             auto call = ast::cast<ast::expressions::call>( n );
@@ -527,11 +847,14 @@ namespace mico { namespace eval {
                 return is_null(chkd) ? fun : chkd;
             }
 
+            state::temp_roots held( env->get_state( ) );
+            held.add( fun );
+
             auto new_env = create_call_env( call, fun.get( ), env, params );
             if( !new_env ) {
                 return error( call, "Bad parameter for 'call'" );
             }
-            return std::make_shared<objects::tail_call>( fun, std::move(params),
+            return mico::make_shared<objects::tail_call>( fun, std::move(params),
                                                          new_env );
         }
 
@@ -558,6 +881,8 @@ namespace mico { namespace eval {
                 if( call_type == objects::type::FUNCTION ) {
                     auto fun = objects::cast_func(call->value( ).get( ));
                     environment::scoped s( call->env( ) );
+                    state::temp_roots held( call->env( )->get_state( ) );
+                    held.add( obj );
                     fun->env( )->get_state( ).GC( fun->env( ) );
                     obj = eval_impl( fun->body( ), call->env( ) );
                 } else if( call_type == objects::type::BUILTIN ) {
@@ -581,6 +906,8 @@ namespace mico { namespace eval {
                 if( call_type == objects::type::FUNCTION ) {
                     auto fun = objects::cast_func(call->value( ).get( ));
                     environment::scoped s( call->env( ) );
+                    state::temp_roots held( call->env( )->get_state( ) );
+                    held.add( obj );
                     fun->env( )->get_state( ).GC( fun->env( ) );
                     obj_src = eval_impl( fun->body( ), call->env( ) );
                 } else if( call_type == objects::type::BUILTIN ) {
@@ -594,18 +921,23 @@ namespace mico { namespace eval {
             return obj_src;
         }
 
-        objects::sptr eval_scope_node( ast::node *n, environment::sptr env )
+        objects::sptr eval_scope_node( ast::node *n,
+                                       const environment::sptr &env )
         {
             call_info::scope scp( call_stack( ), n );
             if( call_stack( )->size( ) > 2048 ) {
                 return error( n, "Stack overflow '", n, "'" );
             }
+            if( budget_ && ++steps_ > budget_ ) {
+                return error( n, "Step budget exceeded" );
+            }
 
             auto scope = ast::cast<ast::expressions::list>( n );
             return eval_scope( scope->value( ), env );
         }
 
-        objects::sptr eval_scope( ast::node_list &lst, environment::sptr env )
+        objects::sptr eval_scope( ast::node_list &lst,
+                                  const environment::sptr &env )
         {
 
             using return_type = ast::statements::ret;
@@ -742,7 +1074,7 @@ namespace mico { namespace eval {
             return error( f, "Is not an itarable object ", from->get_type( ) );
         }
 
-        objects::sptr eval_forin( ast::node *n, environment::sptr env )
+        objects::sptr eval_forin( ast::node *n, const environment::sptr &env )
         {
             auto fori = ast::cast<ast::expressions::forin>( n );
 
@@ -780,12 +1112,15 @@ namespace mico { namespace eval {
                 ident[id++] = ii->value( );
             }
 
+            state::temp_roots held( env->get_state( ) );
+
             id = 0;
             for( auto &e: fori->expres( )->value( ) ) {
                 auto obj = eval_impl_tail( e.get( ), env );
                 if( is_fail( obj ) ) {
                     return obj;
                 }
+                held.add( obj );
 
                 nodes[id]    = e.get( );
                 expres[id++] = obj;
@@ -806,10 +1141,15 @@ namespace mico { namespace eval {
             id = 0;
 
             objects::sptr res = get_null( );
+            environment::sptr body;
 
             while( !gen->end( ) ) {
 
-                environment::scoped s(make_env(env));
+                if( !body || !environment::recycle( body ) ) {
+                    body = make_env( env,
+                                     scope_layout( fori->body( ).get( ) ) );
+                }
+                environment::scoped s(body);
                 env->get_state( ).GC( env );
 
                 size_t last_id = 1;
@@ -850,7 +1190,7 @@ namespace mico { namespace eval {
             return expres[0];
         }
 
-        objects::sptr eval_ifelse( ast::node *n, environment::sptr env )
+        objects::sptr eval_ifelse( ast::node *n, const environment::sptr &env )
         {
             auto ifblock = ast::cast<ast::expressions::ifelse>( n );
 
@@ -875,13 +1215,15 @@ namespace mico { namespace eval {
                            ? !bres->value( )
                            : bres->value( );
                 if( value ) {
-                    environment::scoped s(make_env(env));
+                    environment::scoped s(make_env( env,
+                                            scope_layout( i.body.get( ) ) ));
                     auto eval_states = eval_impl( i.body.get( ), s.env( ));
                     return unref(eval_states);
                 }
             }
             if( ifblock->alt( ) ) {
-                environment::scoped s(make_env(env));
+                auto lay = scope_layout( ifblock->alt( ).get( ) );
+                environment::scoped s(make_env( env, lay ));
                 auto eval_states = eval_impl( ifblock->alt( ).get( ),
                                               s.env( ) );
                 return unref(eval_states);
@@ -889,7 +1231,7 @@ namespace mico { namespace eval {
             return get_null( );
         }
 
-        objects::sptr eval_program( ast::node *n, environment::sptr env )
+        objects::sptr eval_program( ast::node *n, const environment::sptr &env )
         {
             auto prog = ast::cast<ast::program>( n );
             objects::sptr last = get_null( );
@@ -902,35 +1244,32 @@ namespace mico { namespace eval {
             return unref(last);
         }
 
-        objects::sptr eval_expression( ast::node *n, environment::sptr env )
+        objects::sptr eval_expression( ast::node *n,
+                                       const environment::sptr &env )
         {
             auto expr = ast::cast<ast::statements::expr>( n );
             return eval_impl( expr->value( ).get( ), env );
         }
 
-        objects::sptr eval_let( ast::node *n, environment::sptr env )
+        objects::sptr eval_let( ast::node *n, const environment::sptr &env )
         {
             auto expr = ast::cast<ast::statements::let>( n );
             if( expr->ident( )->get_type( ) != ast::type::IDENT ) {
                 return error(n, "Bad identifier '", expr->ident( )->str( ),
                              "' for let statement");
             }
-            auto id   = expr->ident( )->str( );
             auto val  = eval_impl_tail( expr->value( ).get( ), env );
             if( is_fail( val ) ) {
                 return val;
             }
 
-            auto uval = unref(val);
-            if( expr->mut( ) ) {
-                env->set( id, uval );
-            } else {
-                env->set_const( id, uval );
-            }
+            using ident = ast::expressions::ident;
+            auto id = ast::cast<ident>( expr->ident( ).get( ) );
+            bind( env.get( ), id, unref( val ), expr->mut( ) );
             return get_null( );
         }
 
-        objects::sptr eval_module( ast::node *n, environment::sptr env )
+        objects::sptr eval_module( ast::node *n, const environment::sptr &env )
         {
             auto mod = ast::cast<ast::expressions::mod>(n);
 
@@ -972,7 +1311,7 @@ namespace mico { namespace eval {
             return mod_obj;
         }
 
-        objects::sptr eval_mut( ast::node *n, environment::sptr env )
+        objects::sptr eval_mut( ast::node *n, const environment::sptr &env )
         {
             auto mm = ast::cast<ast::expressions::mod_mut>(n);
             auto val = unref(eval_impl( mm->value( ).get( ), env ));
@@ -983,7 +1322,7 @@ namespace mico { namespace eval {
             return val;
         }
 
-        objects::sptr eval_const( ast::node *n, environment::sptr env )
+        objects::sptr eval_const( ast::node *n, const environment::sptr &env )
         {
             auto mm = ast::cast<ast::expressions::mod_const>(n);
             auto val = unref(eval_impl( mm->value( ).get( ), env ));
@@ -994,11 +1333,11 @@ namespace mico { namespace eval {
             return val;
         }
 
-        objects::sptr eval_return( ast::node *n, environment::sptr env )
+        objects::sptr eval_return( ast::node *n, const environment::sptr &env )
         {
             auto expr = ast::cast<ast::statements::ret>( n );
             auto val  = eval_impl( expr->value( ), env );
-            return std::make_shared<objects::retutn_obj>(val);
+            return mico::make_shared<objects::retutn_obj>(val);
         }
 
         objects::sptr eval_break( ast::node * /*n*/, environment::sptr /*env*/ )
@@ -1017,11 +1356,11 @@ namespace mico { namespace eval {
             return objects::infinite::make(expr->is_negative( ));
         }
 
-        objects::sptr eval_ident( ast::node *n, environment::sptr env )
+        objects::sptr eval_ident( ast::node *n, const environment::sptr &env )
         {
 
             auto expr = ast::cast<ast::expressions::ident>( n );
-            auto val = env->get( expr->value( ) );
+            auto val = lookup( expr, env.get( ), false );
             if( !val ) {
                 return error( n, "Identifier not found '", n->str( ), "'" );
             } else {
@@ -1029,7 +1368,8 @@ namespace mico { namespace eval {
             }
         }
 
-        objects::sptr eval_function( ast::node *n, environment::sptr env )
+        objects::sptr eval_function( ast::node *n,
+                                     const environment::sptr &env )
         {
             auto func = ast::cast<ast::expressions::function>( n );
             auto init_size = func->inits( ).size( );
@@ -1037,8 +1377,8 @@ namespace mico { namespace eval {
                 init_size = func->param_size( );
             }
             auto fff  = objects::function::make( make_env(env),
-                                                 func->params( )->clone_me( ),
-                                                 func->body( )->clone( ),
+                                                 func->params( ),
+                                                 func->body( ),
                                                  init_size );
 
             for( auto &next: func->inits( ) ) {
@@ -1051,7 +1391,7 @@ namespace mico { namespace eval {
             return fff;
         }
 
-        objects::sptr eval_index( ast::node *n, environment::sptr env )
+        objects::sptr eval_index( ast::node *n, const environment::sptr &env )
         {
             auto idx = ast::cast<ast::expressions::index>(n);
 
@@ -1061,10 +1401,22 @@ namespace mico { namespace eval {
                 return val;
             }
 
-            auto idx_call = [this](ast::node *n, environment::sptr env ) {
+            state::temp_roots held( env->get_state( ) );
+            held.add( val );
+
+            auto idx_call = [this]( ast::node *n,
+                                    const environment::sptr &env ) {
                 return unref( eval_impl_tail( n, env ) );
             };
 
+            return eval_index_obj( idx, val, idx_call, env );
+        }
+
+        objects::sptr eval_index_obj( ast::expressions::index *idx,
+                                      const objects::sptr &val,
+                                      const operations::eval_call &idx_call,
+                                      const environment::sptr &env )
+        {
             using OP_array   = operations::operation<objects::type::ARRAY>;
             using OP_string  = operations::operation<objects::type::STRING>;
             using OP_rstring = operations::operation<objects::type::RSTRING>;
@@ -1090,13 +1442,14 @@ namespace mico { namespace eval {
                 return OP_aslice::eval_index( idx, val, idx_call, env );
             }
 
-            return objects::error::make( n->pos( ),
+            return objects::error::make( idx->pos( ),
                                          "Impossible to get an index of ",
                                          idx->value( )->get_type( ) );
         }
 
         objects::slist eval_parameters( ast::expressions::call *call,
-                                        environment::sptr env )
+                                        const environment::sptr &env,
+                                        state::temp_roots &held )
         {
             objects::slist res;
             for( auto &e: call->param_list( ) ) {
@@ -1104,6 +1457,7 @@ namespace mico { namespace eval {
                 if( is_fail(next) ) {
                     return objects::slist { next };
                 }
+                held.add( next );
                 res.emplace_back( next );
             }
             return res;
@@ -1111,7 +1465,7 @@ namespace mico { namespace eval {
 
         objects::sptr check_args_count( ast::expressions::call *call,
                                         objects::base *fun,
-                                        environment::sptr env )
+                                        const environment::sptr &env )
         {
             using ident_type = ast::expressions::ident;
 
@@ -1154,8 +1508,7 @@ namespace mico { namespace eval {
         }
 
         struct call_info {
-            using uptr = std::unique_ptr<call_info>;
-            using list = std::deque<uptr>;
+            using list = std::deque<call_info>;
 
             explicit
             call_info( ast::node *n )
@@ -1167,7 +1520,7 @@ namespace mico { namespace eval {
                 scope( list *lst, ast::node *n )
                     :lst_(lst)
                 {
-                    lst->emplace_back( uptr(new call_info(n) ) );
+                    lst->emplace_back( n );
                 }
 
                 ~scope( )
@@ -1193,12 +1546,21 @@ namespace mico { namespace eval {
 
         objects::sptr eval_call_obj( ast::expressions::call *call,
                                      objects::sptr fun,
-                                     environment::sptr env )
+                                     const environment::sptr &env )
         {
             fun = unref(fun);
             if( fun->get_type( ) == objects::type::FUNCTION ) {
 
                 auto vfun = objects::cast_func(fun.get( ));
+                if( !vfun->env( ) ) {
+                    return error( call, "Environment of the function '",
+                                  call->func( ).get( ), "' is lost" );
+                }
+
+                /// the function can be a temporary; its environment must
+                /// outlive the arguments and the body
+                state::temp_roots held( env->get_state( ) );
+                held.add( fun );
 
                 vfun->env( )->get_state( ).GC( vfun->env( ) );
 
@@ -1232,7 +1594,10 @@ namespace mico { namespace eval {
                 vfun->env( )->get_state( ).GC( vfun->env( ) );
 
                 vfun->init( s.env( ) );
-                auto params = eval_parameters(call, s.env( ));
+                /// the builtin's environment is empty here; arguments see
+                /// the caller's scope directly
+                state::temp_roots held( env->get_state( ) );
+                auto params = eval_parameters( call, env, held );
                 if( params.size( ) == 1 && is_fail( params[0] ) ) {
                     return params[0];
                 }
@@ -1244,7 +1609,7 @@ namespace mico { namespace eval {
         }
 
         objects::sptr eval_call_impl( ast::node *n,
-                                      environment::sptr env,
+                                      const environment::sptr &env,
                                       environment::sptr &/*work_env*/ )
         {
             call_info::scope scp( call_stack( ), n);
@@ -1264,12 +1629,12 @@ namespace mico { namespace eval {
                               fun->get_type( ), "(", fun, ")",
                               " is not a callable object" );
             }
-            return eval_call_obj( call, fun, env );
+            return eval_call_obj( call, std::move(fun), env );
 
 
         }
 
-        objects::sptr eval_call( ast::node *n, environment::sptr env )
+        objects::sptr eval_call( ast::node *n, const environment::sptr &env )
         {
             environment::sptr we;
             auto res = eval_call_impl( n, env, we );
@@ -1277,10 +1642,12 @@ namespace mico { namespace eval {
             return res;
         }
 
-        objects::sptr eval_array( ast::node *n, environment::sptr env )
+        objects::sptr eval_array( ast::node *n, const environment::sptr &env )
         {
             auto arr = ast::cast<ast::expressions::array>( n );
             auto res = objects::array::make( env );
+            state::temp_roots held( env->get_state( ) );
+            held.add( res );
 
             for( auto &a: arr->value( ) ) {
                 auto next = eval_impl( a.get( ), env );
@@ -1293,11 +1660,13 @@ namespace mico { namespace eval {
             return res;
         }
 
-        objects::sptr eval_table( ast::node *n, environment::sptr env )
+        objects::sptr eval_table( ast::node *n, const environment::sptr &env )
         {
             auto table = ast::cast<ast::expressions::table>( n );
 
             auto res = objects::table::make( env );
+            state::temp_roots held( env->get_state( ) );
+            held.add( res );
 
             for( auto &v: table->value( ) ) {
                 auto key = unref( eval_impl_tail( v.first.get( ), env ) );
@@ -1311,6 +1680,7 @@ namespace mico { namespace eval {
                     return error( v.first.get( ), "unusable as hash key: ",
                                                    key->get_type( ));
                 }
+                held.add( key );
 
                 auto val = unref(eval_impl_tail( v.second.get( ), env ));
                 if( is_fail( val ) ) {
@@ -1356,7 +1726,7 @@ namespace mico { namespace eval {
             return nullptr;
         }
 
-        objects::sptr eval_quote( ast::node *n, environment::sptr env )
+        objects::sptr eval_quote( ast::node *n, const environment::sptr &env )
         {
             auto quo = ast::cast<ast::expressions::quote>(n);
             ast::node::apply_mutator( quo->value( ),
@@ -1366,7 +1736,7 @@ namespace mico { namespace eval {
             return objects::quote::make( quo->value( )->clone( ) );
         }
 
-        objects::sptr eval_unquote( ast::node *n, environment::sptr env )
+        objects::sptr eval_unquote( ast::node *n, const environment::sptr &env )
         {
             auto quo = ast::cast<ast::expressions::unquote>(n);
             auto res = eval_impl_tail_ret( quo->value( ).get( ), env );
@@ -1379,19 +1749,32 @@ namespace mico { namespace eval {
         }
 #endif
 
-        objects::sptr eval_impl_tail( ast::node *n, environment::sptr env )
+        objects::sptr eval_impl_tail( ast::node *n,
+                                      const environment::sptr &env )
         {
             auto res = eval_impl(n, env);
-            return eval_tail( res );
+            return eval_tail( std::move(res) );
         }
 
-        objects::sptr eval_impl_tail_ret( ast::node *n, environment::sptr env )
+        /// the body of a function is parsed the first time it is called
+        objects::sptr eval_lazy( ast::node *n, const environment::sptr &env )
+        {
+            auto lz = ast::cast<ast::expressions::lazy>( n );
+            auto &body( lz->get( ) );
+            if( !lz->errors( ).empty( ) ) {
+                return error( n, lz->errors( ).front( ) );
+            }
+            return eval_impl( body.get( ), env );
+        }
+
+        objects::sptr eval_impl_tail_ret( ast::node *n,
+                                          const environment::sptr &env )
         {
             auto res = eval_impl(n, env);
             return eval_tail_return( res );
         }
 
-        objects::sptr eval_impl( ast::node *n, environment::sptr env )
+        objects::sptr eval_impl( ast::node *n, const environment::sptr &env )
         {
             objects::sptr res = get_null( );
             switch (n->get_type( )) {
@@ -1452,6 +1835,8 @@ namespace mico { namespace eval {
                 res = eval_scope_node( n, env ); break;
             case ast::type::MODULE:
                 res = eval_module( n, env ); break;
+            case ast::type::LAZY:
+                res = eval_lazy( n, env ); break;
 
 #if !defined(DISABLE_MACRO) || !DISABLE_MACRO
             case ast::type::QUOTE:
@@ -1473,8 +1858,23 @@ namespace mico { namespace eval {
             return eval_impl( n, env );
         }
 
+        /// every scope that is evaluated (a call, an iteration) is a step;
+        /// after 'steps' of them everything fails. 0 is no limit
+        void set_budget( std::size_t steps )
+        {
+            budget_ = steps;
+            steps_  = 0;
+        }
+
+        std::size_t steps( ) const
+        {
+            return steps_;
+        }
+
     private:
-        error_list errors_;
+        error_list   errors_;
+        std::size_t  budget_ = 0;
+        std::size_t  steps_  = 0;
     };
 
 }}
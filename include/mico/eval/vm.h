@@ -0,0 +1,1043 @@
+#ifndef MICO_EVAL_VM_H
+#define MICO_EVAL_VM_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "mico/eval/tree_walking.h"
+#include "mico/eval/bytecode.h"
+
+namespace mico { namespace eval {
+
+    /// Compiles AST into a flat bytecode and runs it on a value stack.
+    /// Nodes that are not worth compiling (modules, quotes) and all the
+    /// type-specific operations are shared with the tree_walking evaluator.
+    class vm: public tree_walking, public state::root_source {
+
+        using opcode      = bytecode::opcode;
+        using instruction = bytecode::instruction;
+        using chunk       = bytecode::chunk;
+        using compiler    = bytecode::compiler;
+
+        static const std::size_t max_depth  = 2048;
+        static const std::size_t max_bodies = 1024;
+
+        struct call_state {
+            objects::sptr           fun;
+            environment::sptr       env;
+            objects::array::sptr    args;
+            objects::slist          params;
+            std::unique_ptr<environment::scoped> hold;
+            std::size_t             limit   = 0;
+            bool                    partial = false;
+            bool                    counted = false;
+            bool                    valid   = true;
+        };
+
+        struct loop_state {
+            objects::sptr             from;
+            objects::generator::sptr  gen;
+            const std::string        *ident[3];
+            layout::sptr              lay;
+            environment::sptr         body;
+            std::int64_t              id = 0;
+        };
+
+        struct body_info {
+            std::weak_ptr<ast::node> body;
+            chunk::sptr              code;
+        };
+
+        /// keeps the stacks balanced for every way out of 'run'
+        struct frame {
+
+            frame( vm *v, environment::sptr env )
+                :vm_(v)
+                ,values_(v->values_.size( ))
+                ,envs_(v->envs_.size( ))
+                ,loops_(v->loops_.size( ))
+                ,calls_(v->calls_.size( ))
+                ,tail_(v->tails_.size( ))
+                ,depth_(v->depth_)
+            {
+                /// the outermost run shows its stacks to the collections
+                if( envs_ == 0 ) {
+                    state_ = &env->get_state( );
+                    state_->add_source( vm_ );
+                }
+                vm_->tails_.emplace_back( );
+                env->mark( );
+                vm_->envs_.emplace_back( std::move(env) );
+            }
+
+            ~frame( )
+            {
+                unwind( );
+                vm_->tails_.resize( tail_ );
+                if( state_ ) {
+                    state_->remove_source( vm_ );
+                }
+            }
+
+            void unwind( )
+            {
+                vm_->tails_.resize( tail_ + 1 );
+                vm_->values_.resize( values_ );
+                vm_->loops_.resize( loops_ );
+                vm_->calls_.resize( calls_ );
+                vm_->unwind_envs( envs_ );
+                vm_->depth_ = depth_;
+            }
+
+            void replace( environment::sptr env )
+            {
+                unwind( );
+                env->mark( );
+                vm_->envs_.emplace_back( std::move(env) );
+            }
+
+            vm         *vm_;
+            std::size_t values_;
+            std::size_t envs_;
+            std::size_t loops_;
+            std::size_t calls_;
+            std::size_t tail_;
+            std::size_t depth_;
+            state      *state_ = nullptr;
+        };
+
+        void unwind_envs( std::size_t size )
+        {
+            while( envs_.size( ) > size ) {
+                envs_.back( )->unmark( );
+                envs_.pop_back( );
+            }
+        }
+
+        objects::sptr pop( )
+        {
+            auto res = std::move(values_.back( ));
+            values_.pop_back( );
+            return res;
+        }
+
+        static
+        bool is_indexable( objects::type tt )
+        {
+            switch( tt ) {
+            case objects::type::ARRAY:
+            case objects::type::STRING:
+            case objects::type::RSTRING:
+            case objects::type::TABLE:
+            case objects::type::SSLICE:
+            case objects::type::RSLICE:
+            case objects::type::ASLICE:
+                return true;
+            default:
+                break;
+            }
+            return false;
+        }
+
+        static
+        bool is_stmt_break( const objects::sptr &obj )
+        {
+            switch( obj->get_type( ) ) {
+            case objects::type::FAILURE:
+            case objects::type::BREAK_OBJ:
+            case objects::type::CONT_OBJ:
+            case objects::type::RETURN:
+                return true;
+            default:
+                break;
+            }
+            return false;
+        }
+
+        static
+        operations::binary::function binary_ops( const objects::sptr &left,
+                                                 const objects::sptr &right,
+                                                 ast::expressions::infix *inf )
+        {
+            return operations::binary::instance( ).get( left->get_type( ),
+                                                        right->get_type( ),
+                                                        inf->token( ) );
+        }
+
+        /// the same rules that operations use for '&&' and '||'
+        static
+        bool need_right( tokens::type tt, const objects::sptr &left )
+        {
+            bool is_and = ( tt == tokens::type::LOGIC_AND );
+            bool is_or  = ( tt == tokens::type::LOGIC_OR );
+
+            switch( left->get_type( ) ) {
+            case objects::type::INTEGER: {
+                auto val = objects::cast_int( left.get( ) )->value( );
+                return !( (is_and && val == 0) || (is_or && val != 0) );
+            }
+            case objects::type::CHARACTER: {
+                auto val = objects::cast_char( left.get( ) )->value( );
+                return !( (is_and && val == 0) || (is_or && val != 0) );
+            }
+            case objects::type::FLOAT: {
+                auto val = objects::cast_float( left.get( ) )->value( );
+                return !( (is_and && val == 0.0) || (is_or && val != 0.0) );
+            }
+            case objects::type::BOOLEAN: {
+                auto val = objects::cast_bool( left.get( ) )->value( );
+                return !( (is_and && !val) || (is_or && val) );
+            }
+            case objects::type::STRING:
+            case objects::type::RSTRING:
+            case objects::type::ARRAY:
+            case objects::type::TABLE:
+                return true;
+            case objects::type::MODULE:
+                return false;
+            default:
+                break;
+            }
+            return tt == tokens::type::BIT_OR;
+        }
+
+        static
+        objects::sptr get_literal( vm *thiz, ast::node *n,
+                                   environment::sptr env )
+        {
+            switch( n->get_type( ) ) {
+            case ast::type::BOOLEAN:
+                return thiz->get_bool( n );
+            case ast::type::INTEGER:
+                return thiz->eval_int( n );
+            case ast::type::FLOAT:
+                return thiz->eval_float( n );
+            case ast::type::STRING:
+                return thiz->eval_string( n );
+            case ast::type::CHARACTER:
+                return thiz->eval_charset( n );
+            case ast::type::INFIN:
+                return thiz->eval_inf( n, env );
+            default:
+                break;
+            }
+            return get_null( );
+        }
+
+        chunk::sptr body_chunk( objects::function *fun )
+        {
+            auto body = fun->body( );
+            auto f = bodies_.find( body );
+            if( f != bodies_.end( ) && !f->second.body.expired( ) ) {
+                return f->second.code;
+            }
+            if( bodies_.size( ) >= max_bodies ) {
+                for( auto b = bodies_.begin( ); b != bodies_.end( ); ) {
+                    b = b->second.body.expired( ) ? bodies_.erase( b ) : ++b;
+                }
+            }
+            auto code = compiler::compile_function_body( body );
+            bodies_[body] = body_info { fun->shared_body( ), code };
+            return code;
+        }
+
+        objects::sptr call_function( objects::function *fun,
+                                     environment::sptr env )
+        {
+            auto res = run( body_chunk( fun ), env );
+            while( is_return( res ) ) {
+                auto r = objects::cast_return( res.get( ) );
+                res = resolve( r->value( ) );
+            }
+            return res;
+        }
+
+        /// the same as tree_walking::eval_tail but calls run the bytecode
+        objects::sptr resolve( objects::sptr obj )
+        {
+            while( true ) {
+                objects::base *tail = nullptr;
+                if( obj->get_type( ) == objects::type::TAIL_CALL ) {
+                    tail = obj.get( );
+                } else if( obj->get_type( ) == objects::type::RETURN ) {
+                    auto ret = objects::cast_return( obj.get( ) );
+                    if( ret->value( )->get_type( ) ==
+                                            objects::type::TAIL_CALL ) {
+                        tail = ret->value( ).get( );
+                    }
+                }
+                if( !tail ) {
+                    break;
+                }
+                auto call = objects::cast_tail_call( tail );
+                auto value = call->value( );
+                if( value->get_type( ) == objects::type::FUNCTION ) {
+                    auto fun = objects::cast_func( value.get( ) );
+                    auto env = call->env( );
+                    environment::scoped s( env );
+                    state::temp_roots held( env->get_state( ) );
+                    held.add( obj );
+                    fun->env( )->get_state( ).GC( fun->env( ) );
+                    obj = call_function( fun, env );
+                } else if( value->get_type( ) == objects::type::BUILTIN ) {
+                    auto fun = objects::cast_builtin( value.get( ) );
+                    obj = fun->call( call->params( ), call->env( ) );
+                } else {
+                    break;
+                }
+            }
+            return obj;
+        }
+
+        objects::sptr finish_call( call_state &cs )
+        {
+            if( cs.fun->get_type( ) == objects::type::BUILTIN ) {
+                auto vfun = objects::cast_builtin( cs.fun.get( ) );
+                auto res = vfun->call( cs.params, cs.env );
+                return resolve( res );
+            }
+
+            auto vfun = objects::cast_func( cs.fun.get( ) );
+            if( cs.partial ) {
+                return objects::function::make( cs.env, *vfun, cs.limit );
+            }
+            if( !cs.valid ) {
+                return get_null( );
+            }
+            if( cs.args ) {
+                using elipsis = ast::expressions::elipsis;
+                using ident   = ast::expressions::ident;
+                auto &last( *(vfun->end( ) - 1) );
+                auto eli = ast::cast<elipsis>( last.get( ) );
+                if( eli->is_ident( ) ) {
+                    auto id = ast::cast<ident>( eli->value( ).get( ) );
+                    cs.env->set( id->value( ), cs.args );
+                } else {
+                    cs.env->set( "__args", cs.args );
+                }
+            }
+            return nullptr;
+        }
+
+        objects::sptr run( chunk::sptr ch, environment::sptr env )
+        {
+            using call_type = ast::expressions::call;
+            using ident     = ast::expressions::ident;
+
+            frame fr( this, env );
+
+            const instruction *code = ch->code.data( );
+            std::size_t pc = 0;
+
+            while( true ) {
+
+                const instruction &ins( code[pc++] );
+                ast::node *n = ins.node;
+
+                switch( ins.op ) {
+                case opcode::NOP:
+                    break;
+                case opcode::PUSH_NULL:
+                    values_.emplace_back( get_null( ) );
+                    break;
+                case opcode::PUSH_LITERAL:
+                    values_.emplace_back( get_literal( this, n,
+                                                       envs_.back( ) ) );
+                    break;
+                case opcode::LOAD:
+                case opcode::LOAD_REF: {
+                    auto id = ast::cast<ident>( n );
+                    auto val = lookup( id, envs_.back( ).get( ),
+                                       ins.op == opcode::LOAD_REF );
+                    if( !val ) {
+                        val = error( n, "Identifier not found '",
+                                     n->str( ), "'" );
+                    }
+                    values_.emplace_back( std::move(val) );
+                    break;
+                }
+                case opcode::REGISTRY:
+                    values_.emplace_back( eval_registry( n, envs_.back( ) ) );
+                    break;
+                case opcode::POP:
+                    values_.pop_back( );
+                    break;
+                case opcode::UNREF:
+                    values_.back( ) = unref( values_.back( ) );
+                    break;
+                case opcode::LET: {
+                    auto &val( values_.back( ) );
+                    if( !is_fail( val ) ) {
+                        auto expr = ast::cast<ast::statements::let>( n );
+                        auto id = ast::cast<ident>( expr->ident( ).get( ) );
+                        bind( envs_.back( ).get( ), id, unref( val ),
+                              ins.a != 0 );
+                        val = get_null( );
+                    }
+                    break;
+                }
+                case opcode::MUT: {
+                    auto val = unref( values_.back( ) );
+                    if( val->is_container( val.get( ) )
+                     && !val->is_mutable( ) ) {
+                        val = val->clone( );
+                        val->set_mutable( true );
+                    }
+                    values_.back( ) = val;
+                    break;
+                }
+                case opcode::CONST: {
+                    auto val = unref( values_.back( ) );
+                    if( val->is_container( val.get( ) )
+                     && val->is_mutable( ) ) {
+                        val = val->clone( );
+                        val->set_mutable( false );
+                    }
+                    values_.back( ) = val;
+                    break;
+                }
+                case opcode::PREFIX: {
+                    auto &oper( values_.back( ) );
+                    if( !is_fail( oper ) ) {
+                        auto expr = ast::cast<ast::expressions::prefix>( n );
+                        oper = eval_prefix_obj( expr, oper );
+                    }
+                    break;
+                }
+                case opcode::INFIX_LEFT: {
+                    auto &left( values_.back( ) );
+                    left = unref( left );
+                    if( is_fail( left ) ) {
+                        pc = ins.a;
+                        break;
+                    }
+                    auto inf = ast::cast<ast::expressions::infix>( n );
+                    if( !need_right( inf->token( ), left ) ) {
+                        auto lazy = [this]( ast::node *n,
+                                            const environment::sptr &e )
+                        {
+                            return unref( resolve( eval( n, e ) ) );
+                        };
+                        /// 'lazy' runs code that can grow the stacks;
+                        /// the operands must not point into them
+                        auto lhs = left;
+                        auto env = envs_.back( );
+                        auto res = eval_infix_obj( inf, lhs, lazy, env );
+                        values_.back( ) = res ? resolve( res )
+                                   : error_operation_notfound( inf->token( ),
+                                                               inf );
+                        pc = ins.a;
+                    }
+                    break;
+                }
+                case opcode::INFIX_RIGHT: {
+                    auto right = unref( pop( ) );
+                    auto &left( values_.back( ) );
+                    auto inf = ast::cast<ast::expressions::infix>( n );
+                    if( is_fail( right ) ) {
+                        left = right;
+                    } else if( is_int( left ) && is_int( right ) ) {
+                        left = eval_num_tmp<objects::type::INTEGER>( inf,
+                                                            left, right );
+                    } else if( is_float( left ) && is_float( right ) ) {
+                        left = eval_num_tmp<objects::type::FLOAT>( inf,
+                                                            left, right );
+                    } else if( auto call = binary_ops( left, right, inf ) ) {
+                        auto res = call( inf, left, right, envs_.back( ) );
+                        values_.back( ) = resolve( res );
+                    } else {
+                        auto ready = [&right]( ast::node *,
+                                               const environment::sptr & )
+                        {
+                            return right;
+                        };
+                        auto res = eval_infix_obj( inf, left, ready,
+                                                   envs_.back( ) );
+                        /// 'resolve' can grow the stack
+                        values_.back( ) = res ? resolve( res )
+                                   : error_operation_notfound( inf->token( ),
+                                                               inf );
+                    }
+                    break;
+                }
+                case opcode::DOT: {
+                    auto &left( values_.back( ) );
+                    left = unref( left );
+                    if( is_fail( left ) ) {
+                        pc = ins.a;
+                        break;
+                    }
+                    if( left->get_type( ) != objects::type::MODULE ) {
+                        pc = ins.b;
+                        break;
+                    }
+                    auto inf = ast::cast<ast::expressions::infix>( n );
+                    auto mod = objects::cast_mod( left.get( ) );
+                    auto right = inf->right( ).get( );
+                    auto rtype = right->get_type( );
+                    auto fn = ( rtype == ast::type::CALL )
+                            ? ast::cast<call_type>( right )->func( ).get( )
+                            : right;
+                    if( rtype != ast::type::IDENT
+                     && ( rtype != ast::type::CALL
+                       || fn->get_type( ) != ast::type::IDENT ) ) {
+                        left = objects::error::make( right->pos( ),
+                                                     "Bad ident for module ",
+                                                     right->str( ) );
+                        pc = ins.a;
+                    } else if( auto val = mod->get( fn->str( ) ) ) {
+                        left = val;
+                        /// a call continues with the arguments
+                        if( rtype != ast::type::CALL ) {
+                            pc = ins.a;
+                        }
+                    } else {
+                        left = objects::error::make( right->pos( ),
+                                                     "Identifier not found '",
+                                                     fn->str( ), "'" );
+                        pc = ins.a;
+                    }
+                    break;
+                }
+                case opcode::ASSIGN_LEFT: {
+                    auto &left( values_.back( ) );
+                    if( left->get_type( ) != objects::type::REFERENCE ) {
+                        auto inf = ast::cast<ast::expressions::infix>( n );
+                        left = error( inf, "Invalid left value for ASSIGN ",
+                                      inf->left( ).get( ) );
+                        pc = ins.a;
+                    }
+                    break;
+                }
+                case opcode::ASSIGN: {
+                    auto rght = unref( pop( ) );
+                    auto &left( values_.back( ) );
+                    if( is_fail( rght ) ) {
+                        left = rght;
+                    } else {
+                        auto cont = objects::cast_ref( left.get( ) );
+                        cont->set_value( envs_.back( ).get( ),
+                                         assign_copy( rght ) );
+                        left = cont->value( );
+                    }
+                    break;
+                }
+                case opcode::IF_COND: {
+                    auto cond = unref( pop( ) );
+                    bool value = false;
+                    switch( cond->get_type( ) ) {
+                    case objects::type::BOOLEAN:
+                        value = objects::cast_bool( cond.get( ) )->value( );
+                        break;
+                    case objects::type::INTEGER:
+                        value = objects::cast_int( cond.get( ) )->value( )
+                                != 0;
+                        break;
+                    case objects::type::FLOAT:
+                        value = objects::cast_float( cond.get( ) )->value( )
+                                != 0.0;
+                        break;
+                    case objects::type::FAILURE:
+                        values_.emplace_back( std::move(cond) );
+                        pc = ins.b;
+                        continue;
+                    default:
+                        values_.emplace_back( error( n, "Failed to convert ",
+                                              cond->get_type( ),
+                                              " to boolean.") );
+                        pc = ins.b;
+                        continue;
+                    }
+                    if( ins.c ) {
+                        value = !value;
+                    }
+                    if( !value ) {
+                        pc = ins.a;
+                    }
+                    break;
+                }
+                case opcode::ENV_PUSH: {
+                    auto e = make_env( envs_.back( ), scope_layout( n ) );
+                    e->mark( );
+                    envs_.emplace_back( std::move(e) );
+                    break;
+                }
+                case opcode::ENV_POP:
+                    envs_.back( )->unmark( );
+                    envs_.pop_back( );
+                    break;
+                case opcode::SCOPE_ENTER:
+                    if( ++depth_ > max_depth ) {
+                        --depth_;
+                        values_.emplace_back( error( n, "Stack overflow '",
+                                                     n, "'" ) );
+                        pc = ins.a;
+                    }
+                    break;
+                case opcode::SCOPE_LEAVE:
+                    --depth_;
+                    break;
+                case opcode::STMT_CHECK:
+                    if( is_stmt_break( values_.back( ) ) ) {
+                        pc = ins.a;
+                    } else {
+                        values_.pop_back( );
+                    }
+                    break;
+                case opcode::PROG_STMT: {
+                    auto &last( values_.back( ) );
+                    if( is_return( last ) ) {
+                        last = resolve( extract_return( last ) );
+                        pc = ins.a;
+                    } else {
+                        values_.pop_back( );
+                    }
+                    break;
+                }
+                case opcode::PROG_LAST: {
+                    auto &last( values_.back( ) );
+                    if( is_return( last ) ) {
+                        last = resolve( extract_return( last ) );
+                    } else {
+                        last = unref( last );
+                    }
+                    break;
+                }
+                case opcode::FOR_FIRST: {
+                    auto &first( values_.back( ) );
+                    if( is_fail( first ) ) {
+                        pc = ins.a;
+                    } else if( is_table( first ) ) {
+                        /// a table has no step; FOR_INIT still pops one
+                        if( code[ins.b].b > 1 ) {
+                            values_.emplace_back( nullptr );
+                        }
+                        pc = ins.b;
+                    }
+                    break;
+                }
+                case opcode::FOR_SECOND: {
+                    if( is_fail( values_.back( ) ) ) {
+                        auto second = pop( );
+                        values_.back( ) = second;
+                        pc = ins.a;
+                    }
+                    break;
+                }
+                case opcode::FOR_INIT: {
+                    auto fori = ast::cast<ast::expressions::forin>( n );
+                    auto &expres( fori->expres( )->value( ) );
+                    objects::sptr step;
+                    ast::node *step_node = nullptr;
+                    if( ins.b > 1 ) {
+                        step = pop( );
+                        step_node = expres[1].get( );
+                    }
+                    auto &from( values_.back( ) );
+                    auto gen_obj = create_generator( from, expres[0].get( ),
+                                                     step, step_node );
+                    if( is_fail( gen_obj ) ) {
+                        from = gen_obj;
+                        pc = ins.a;
+                        break;
+                    }
+                    loop_state ls;
+                    ls.from = pop( );
+                    ls.gen  = objects::cast_gen( gen_obj );
+                    ls.lay  = scope_layout( fori->body( ).get( ) );
+                    std::size_t id = 0;
+                    for( auto &i: fori->idents( )->value( ) ) {
+                        ls.ident[id++] = &ast::cast<ident>( i.get( ) )
+                                                            ->value( );
+                    }
+                    for( ; id < 3; ++id ) {
+                        ls.ident[id] = nullptr;
+                    }
+                    loops_.emplace_back( std::move(ls) );
+                    break;
+                }
+                case opcode::FOR_ITER: {
+                    auto &ls( loops_.back( ) );
+                    if( ls.gen->end( ) ) {
+                        pc = ins.a;
+                        break;
+                    }
+                    auto cur = envs_.back( );
+                    if( !ls.body || !environment::recycle( ls.body ) ) {
+                        ls.body = make_env( cur, ls.lay );
+                    }
+                    auto e = ls.body;
+                    e->mark( );
+                    envs_.push_back( e );
+                    cur->get_state( ).GC( cur );
+
+                    std::size_t last_id = 1;
+                    auto val = ls.gen->get_val( );
+                    if( !ls.ident[1] ) {
+                        e->set_const( *ls.ident[0], val );
+                    } else {
+                        e->set_const( *ls.ident[0], ls.gen->get_id( ) );
+                        e->set_const( *ls.ident[1], val );
+                        last_id = 2;
+                    }
+                    if( last_id < 3 && ls.ident[last_id] ) {
+                        e->set( *ls.ident[last_id],
+                                objects::integer::make( ls.id++ ) );
+                    }
+                    break;
+                }
+                case opcode::FOR_STEP: {
+                    auto next = pop( );
+                    envs_.back( )->unmark( );
+                    envs_.pop_back( );
+                    if( is_return( next ) || is_fail( next ) ) {
+                        loops_.pop_back( );
+                        values_.emplace_back( std::move(next) );
+                        pc = ins.b;
+                    } else if( is_break( next ) ) {
+                        pc = ins.a;
+                    }
+                    break;
+                }
+                case opcode::FOR_NEXT:
+                    loops_.back( ).gen->next( );
+                    pc = ins.a;
+                    break;
+                case opcode::FOR_EXIT:
+                    values_.emplace_back( std::move(loops_.back( ).from) );
+                    loops_.pop_back( );
+                    break;
+                case opcode::BREAK_OBJ:
+                    values_.emplace_back( objects::break_obj::make( ) );
+                    break;
+                case opcode::CONT_OBJ:
+                    values_.emplace_back( objects::cont_obj::make( ) );
+                    break;
+                case opcode::UNWIND:
+                    unwind_envs( fr.envs_ + 1 + ins.a );
+                    depth_ = fr.depth_ + ins.b;
+                    break;
+                case opcode::JUMP:
+                    pc = ins.a;
+                    break;
+                case opcode::RET:
+                    return pop( );
+                case opcode::RET_OBJ:
+                    values_.back( ) = do_return( values_.back( ) );
+                    break;
+                case opcode::CALL_BEGIN: {
+                    auto call = ast::cast<call_type>( n );
+                    auto fun = unref( pop( ) );
+                    if( is_fail( fun ) ) {
+                        values_.emplace_back( std::move(fun) );
+                        pc = ins.a;
+                        break;
+                    }
+                    if( !is_func( fun ) ) {
+                        values_.emplace_back( error( call->func( ).get( ),
+                                     fun->get_type( ), "(", fun, ")",
+                                     " is not a callable object" ) );
+                        pc = ins.a;
+                        break;
+                    }
+                    call_state cs;
+                    cs.counted = ( ins.c & bytecode::CALL_COUNTED ) != 0;
+                    if( cs.counted && ( ++depth_ > max_depth ) ) {
+                        --depth_;
+                        values_.emplace_back( error( call, "Stack overflow '",
+                                                     call, "'" ) );
+                        pc = ins.a;
+                        break;
+                    }
+                    auto argc = static_cast<std::size_t>(ins.b);
+                    if( fun->get_type( ) == objects::type::FUNCTION ) {
+                        auto vfun = objects::cast_func( fun.get( ) );
+                        if( !vfun->env( ) ) {
+                            if( cs.counted ) {
+                                --depth_;
+                            }
+                            values_.emplace_back( error( call,
+                                "Environment of the function '",
+                                call->func( ).get( ), "' is lost" ) );
+                            pc = ins.a;
+                            break;
+                        }
+                        state::temp_roots held( vfun->env( )->get_state( ) );
+                        held.add( fun );
+                        vfun->env( )->get_state( ).GC( vfun->env( ) );
+                        auto total = vfun->param_size( )
+                                   - vfun->is_elipsis( );
+                        if( argc < total ) {
+                            if( argc == 0 ) {
+                                if( cs.counted ) {
+                                    --depth_;
+                                }
+                                values_.emplace_back( std::move(fun) );
+                                pc = ins.a;
+                                break;
+                            }
+                            cs.partial = true;
+                            cs.limit   = argc;
+                        } else if( vfun->is_elipsis( ) ) {
+                            cs.limit = argc;
+                        } else {
+                            cs.limit = std::min( argc, vfun->param_size( ) );
+                        }
+                        auto lay = cs.partial ? layout::sptr( )
+                                              : scope_layout( vfun->body( ) );
+                        cs.env = environment::make( vfun->env( ), lay );
+                        if( !cs.partial && vfun->is_elipsis( ) ) {
+                            cs.args = objects::array::make( cs.env );
+                        }
+                    } else {
+                        auto vfun = objects::cast_builtin( fun.get( ) );
+                        cs.env = make_env( envs_.back( ) );
+                        cs.hold.reset( new environment::scoped( cs.env ) );
+                        vfun->env( )->get_state( ).GC( vfun->env( ) );
+                        vfun->init( cs.env );
+                        cs.limit = argc;
+                    }
+                    cs.fun = std::move(fun);
+                    calls_.emplace_back( std::move(cs) );
+                    if( calls_.back( ).limit == 0 ) {
+                        pc = ins.a - 1;
+                    }
+                    break;
+                }
+                case opcode::CALL_ARG: {
+                    auto v = unref( pop( ) );
+                    auto &cs( calls_.back( ) );
+                    auto id = static_cast<std::size_t>(ins.c);
+                    if( cs.fun->get_type( ) == objects::type::BUILTIN ) {
+                        if( is_fail( v ) ) {
+                            if( cs.counted ) {
+                                --depth_;
+                            }
+                            calls_.pop_back( );
+                            values_.emplace_back( std::move(v) );
+                            pc = ins.b;
+                            break;
+                        }
+                        cs.params.emplace_back( std::move(v) );
+                    } else {
+                        auto vfun = objects::cast_func( cs.fun.get( ) );
+                        auto p = ( id < vfun->param_size( ) )
+                               ? (vfun->begin( ) + id)->get( )
+                               : nullptr;
+                        auto ptype = p ? p->get_type( ) : ast::type::ELIPSIS;
+                        if( ptype == ast::type::IDENT ) {
+                            auto name = ast::cast<ident>( p );
+                            bind( cs.env.get( ), name, v, true );
+                        } else if( !cs.partial
+                                && ptype == ast::type::ELIPSIS ) {
+                            cs.args->push( cs.env.get( ), v );
+                        } else if( cs.partial ) {
+                            if( cs.counted ) {
+                                --depth_;
+                            }
+                            calls_.pop_back( );
+                            values_.emplace_back( error( n,
+                                                  "Invalid argument ", id,
+                                                  p->str( ) ) );
+                            pc = ins.b;
+                            break;
+                        } else {
+                            cs.valid = false;
+                            pc = ins.a;
+                            break;
+                        }
+                    }
+                    if( id + 1 >= cs.limit ) {
+                        pc = ins.a;
+                    }
+                    break;
+                }
+                case opcode::CALL_END: {
+                    auto cs = std::move(calls_.back( ));
+                    calls_.pop_back( );
+                    auto res = finish_call( cs );
+                    if( !res ) {
+                        auto vfun = objects::cast_func( cs.fun.get( ) );
+                        state::temp_roots held( cs.env->get_state( ) );
+                        held.add( cs.fun );
+                        res = call_function( vfun, cs.env );
+                    }
+                    if( cs.counted ) {
+                        --depth_;
+                    }
+                    values_.emplace_back( std::move(res) );
+                    break;
+                }
+                case opcode::TAIL_END: {
+                    auto cs = std::move(calls_.back( ));
+                    calls_.pop_back( );
+                    auto res = finish_call( cs );
+                    if( res ) {
+                        return res;
+                    }
+                    auto vfun = objects::cast_func( cs.fun.get( ) );
+                    fr.replace( cs.env );
+                    vfun->env( )->get_state( ).GC( vfun->env( ) );
+                    /// a tail call owns the body that is running now
+                    tails_[fr.tail_] = cs.fun;
+                    ch   = body_chunk( vfun );
+                    code = ch->code.data( );
+                    pc   = 0;
+                    break;
+                }
+                case opcode::MAKE_FUNCTION: {
+                    auto &proto( ch->protos[ins.a] );
+                    auto &cur( envs_.back( ) );
+                    values_.emplace_back( mico::make_shared<objects::function>(
+                                          make_env( cur ), proto.params,
+                                          proto.body, proto.init_size ) );
+                    break;
+                }
+                case opcode::FN_INIT: {
+                    auto res = unref( pop( ) );
+                    if( is_fail( res ) ) {
+                        values_.back( ) = res;
+                        pc = ins.b;
+                    } else {
+                        envs_.back( )->set( ch->names[ins.a], res );
+                    }
+                    break;
+                }
+                case opcode::ARRAY_NEW:
+                    values_.emplace_back( objects::array::make(
+                                                        envs_.back( ) ) );
+                    break;
+                case opcode::ARRAY_PUSH: {
+                    auto next = pop( );
+                    if( is_fail( next ) ) {
+                        values_.back( ) = next;
+                        pc = ins.a;
+                    } else {
+                        auto arr = objects::cast_array( values_.back( ).get());
+                        arr->push( envs_.back( ).get( ), unref( next ) );
+                    }
+                    break;
+                }
+                case opcode::TABLE_NEW:
+                    values_.emplace_back( objects::table::make(
+                                                        envs_.back( ) ) );
+                    break;
+                case opcode::TABLE_KEY: {
+                    auto key = unref( pop( ) );
+                    auto kt = key->get_type( );
+                    if( is_fail( key ) ) {
+                        values_.back( ) = key;
+                        pc = ins.a;
+                    } else if( ( kt == objects::type::FUNCTION )
+                            || ( kt == objects::type::BUILTIN )
+                            || ( kt == objects::type::MODULE ) ) {
+                        values_.back( ) = error( n, "unusable as hash key: ",
+                                                 kt );
+                        pc = ins.a;
+                    } else {
+                        values_.emplace_back( std::move(key) );
+                    }
+                    break;
+                }
+                case opcode::TABLE_SET: {
+                    auto val = unref( pop( ) );
+                    auto key = pop( );
+                    if( is_fail( val ) ) {
+                        values_.back( ) = val;
+                        pc = ins.a;
+                    } else {
+                        auto tbl = objects::cast_table( values_.back( ).get());
+                        tbl->set( envs_.back( ).get( ), key, val );
+                    }
+                    break;
+                }
+                case opcode::INDEX_VALUE: {
+                    auto &val( values_.back( ) );
+                    val = unref( val );
+                    if( is_fail( val ) ) {
+                        pc = ins.a;
+                    } else if( !is_indexable( val->get_type( ) ) ) {
+                        auto idx = ast::cast<ast::expressions::index>( n );
+                        val = objects::error::make( n->pos( ),
+                                       "Impossible to get an index of ",
+                                       idx->value( )->get_type( ) );
+                        pc = ins.a;
+                    }
+                    break;
+                }
+                case opcode::INDEX: {
+                    auto param = unref( pop( ) );
+                    auto &val( values_.back( ) );
+                    auto idx = ast::cast<ast::expressions::index>( n );
+                    auto ready = [&param]( ast::node *,
+                                           const environment::sptr & ) {
+                        return param;
+                    };
+                    val = eval_index_obj( idx, val, ready, envs_.back( ) );
+                    break;
+                }
+                case opcode::RUN_CHUNK:
+                    values_.emplace_back( run( ch->children[ins.a],
+                                               envs_.back( ) ) );
+                    break;
+                case opcode::FALLBACK: {
+                    /// 'envs_' can grow while the node is evaluated
+                    auto env = envs_.back( );
+                    values_.emplace_back( resolve( eval_impl( n, env ) ) );
+                    break;
+                }
+                case opcode::END:
+                    return pop( );
+                }
+            }
+        }
+
+    public:
+
+        vm( )
+        { }
+
+        objects::sptr eval( ast::node *n, environment::sptr env ) override
+        {
+            if( n->get_type( ) == ast::type::PROGRAM ) {
+                return run( compiler::compile_program( n ), env );
+            }
+            return run( compiler::compile_expression( n ), env );
+        }
+
+        /// the operand stack, the calls that collect their arguments, the
+        /// loops and the functions that run their body now
+        void roots( std::vector<const objects::base *> &res ) const override
+        {
+            for( auto &v: values_ ) {
+                res.push_back( v.get( ) );
+            }
+            for( auto &c: calls_ ) {
+                res.push_back( c.fun.get( ) );
+                res.push_back( c.args.get( ) );
+                for( auto &p: c.params ) {
+                    res.push_back( p.get( ) );
+                }
+            }
+            for( auto &l: loops_ ) {
+                res.push_back( l.from.get( ) );
+            }
+            for( auto &t: tails_ ) {
+                res.push_back( t.get( ) );
+            }
+        }
+
+    private:
+
+        std::vector<objects::sptr>      values_;
+        std::vector<environment::sptr>  envs_;
+        std::vector<loop_state>         loops_;
+        std::vector<call_state>         calls_;
+        std::vector<objects::sptr>      tails_;
+        std::size_t                     depth_ = 0;
+        std::unordered_map<const ast::node *, body_info> bodies_;
+    };
+
+}}
+
+#endif // MICO_EVAL_VM_H
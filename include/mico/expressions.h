@@ -25,5 +25,6 @@
 #include "mico/expressions/character.h"
 #include "mico/expressions/infinite.h"
 #include "mico/expressions/mutablity.h"
+#include "mico/expressions/lazy.h"
 
 #endif // EXPRESSIONS_H
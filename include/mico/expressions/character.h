@@ -11,7 +11,8 @@
 namespace mico { namespace ast { namespace expressions {
 
     template <>
-    class impl<type::CHARACTER>: public typed_expr<type::CHARACTER> {
+    class impl<type::CHARACTER>: public typed_expr<type::CHARACTER>,
+                                 public literal_object {
 
         using this_type = impl<type::CHARACTER>;
 
@@ -53,7 +54,9 @@ namespace mico { namespace ast { namespace expressions {
 
         ast::node::uptr clone( ) const override
         {
-            return uptr( new this_type(value_ ) );
+            uptr res( new this_type(value_ ) );
+            res->object_ = object_;
+            return ast::node::uptr( std::move(res) );
         }
 
     private:
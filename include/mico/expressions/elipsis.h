@@ -63,7 +63,7 @@ namespace mico { namespace ast { namespace expressions {
 
         ast::node::uptr clone( ) const override
         {
-            return uptr(new this_type(value_->clone( )));
+            return uptr(new this_type(node::call_clone( value_ )));
         }
 
     private:
@@ -27,6 +27,10 @@ namespace mico { namespace ast { namespace expressions {
         using list_type    = expressions::impl<ast::type::LIST>;
         using params_type  = list_type::uptr;
 
+        /// function objects made from the literal share these
+        using body_ptr     = ast::node::sptr;
+        using params_ptr   = std::shared_ptr<list_type>;
+
         impl( )
             :params_(list_type::make_params( ))
         { }
@@ -60,7 +64,7 @@ namespace mico { namespace ast { namespace expressions {
             return inits_;
         }
 
-        const params_type &params( ) const
+        const params_ptr &params( ) const
         {
             return params_;
         }
@@ -70,19 +74,19 @@ namespace mico { namespace ast { namespace expressions {
             return params_->value( ).size( );
         }
 
-        const body_type &body( ) const
+        const body_ptr &body( ) const
         {
             return body_;
         }
 
         void set_body( body_type val )
         {
-            body_ = std::move(val);
+            body_ = body_ptr( std::move(val) );
         }
 
         void set_params( params_type val )
         {
-            params_ = std::move(val);
+            params_ = params_ptr( std::move(val) );
         }
 
         void mutate( mutator_type call ) override
@@ -90,8 +94,20 @@ namespace mico { namespace ast { namespace expressions {
             for( auto &ini: inits_ ) {
                 ast::node::apply_mutator( ini.second, call );
             }
-            list_type::apply_mutator( params_, call );
-            ast::node::apply_mutator( body_,   call );
+            /// the same as list_type::apply_mutator and
+            /// node::apply_mutator but for the shared parts
+            if( auto res = call( params_.get( ) ) ) {
+                if( res->get_type( ) == params_->get_type( ) ) {
+                    params_ = params_ptr( ast::cast<list_type>( res ) );
+                } else {
+                    auto new_list = params_->make_copy( );
+                    new_list->value( ).emplace_back( params_->clone( ) );
+                    params_ = params_ptr( std::move(new_list) );
+                }
+            }
+            if( auto res = call( body_.get( ) ) ) {
+                body_ = body_ptr( std::move(res) );
+            }
         }
 
         bool is_const( ) const override
@@ -107,14 +123,14 @@ namespace mico { namespace ast { namespace expressions {
                                      node::call_clone( ini.second ) );
             }
             res->params_ = params_->clone_me( );
-            res->body_   = ast::node::call_clone( body_ );
+            res->body_   = node::call_clone( body_ );
             return ast::node::uptr( std::move( res ) );
         }
 
     private:
         init_map     inits_;
-        params_type  params_;
-        body_type    body_;
+        params_ptr   params_;
+        body_ptr     body_;
     };
 
     using function = impl<type::FN>;
@@ -4,6 +4,7 @@
 #include <sstream>
 #include "mico/ast.h"
 #include "mico/tokens.h"
+#include "mico/layout.h"
 #include "mico/expressions/impl.h"
 
 namespace mico { namespace ast { namespace expressions {
@@ -21,16 +22,59 @@ namespace mico { namespace ast { namespace expressions {
             :value_(val)
         { }
 
+        /// 'name' is what the source says; the folder renames the locals
+        /// of the bodies it puts in place of calls
+        impl( const std::string &val, const std::string &name )
+            :value_(val)
+            ,name_(name == val ? std::string( ) : name)
+        { }
+
+        /// the name for messages
         std::string str( ) const override
         {
-            return value_;
+            return name_.empty( ) ? value_ : name_;
         }
 
+        /// the name for lookups
         const std::string &value( ) const
         {
             return value_;
         }
 
+        const std::string &name( ) const
+        {
+            return name_.empty( ) ? value_ : name_;
+        }
+
+        /// 'depth' environments up, slot 'slot' of the 'owner' layout
+        void resolve( std::size_t depth, std::size_t slot,
+                      layout::sptr owner )
+        {
+            depth_ = depth;
+            slot_  = slot;
+            owner_ = std::move(owner);
+        }
+
+        bool is_resolved( ) const
+        {
+            return !!owner_;
+        }
+
+        std::size_t depth( ) const
+        {
+            return depth_;
+        }
+
+        std::size_t slot( ) const
+        {
+            return slot_;
+        }
+
+        const layout *owner( ) const
+        {
+            return owner_.get( );
+        }
+
         void mutate( mutator_type /*call*/ ) override
         {
             /// hm...
@@ -42,6 +86,12 @@ namespace mico { namespace ast { namespace expressions {
             return uptr(new this_type( name  ) );
         }
 
+        static
+        uptr make( const std::string &val, const std::string &name )
+        {
+            return uptr(new this_type( val, name ) );
+        }
+
         bool is_const( ) const override
         {
             return false;
@@ -49,11 +99,18 @@ namespace mico { namespace ast { namespace expressions {
 
         ast::node::uptr clone( ) const override
         {
-            return uptr(new this_type(value_));
+            uptr res(new this_type(value_));
+            res->name_ = name_;
+            res->resolve( depth_, slot_, owner_ );
+            return ast::node::uptr( std::move( res ) );
         }
 
     private:
-        std::string value_;
+        std::string  value_;
+        std::string  name_;
+        std::size_t  depth_ = 0;
+        std::size_t  slot_  = 0;
+        layout::sptr owner_;
     };
 
     using ident = impl<type::IDENT>;
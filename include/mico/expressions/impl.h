@@ -1,13 +1,40 @@
 #ifndef MICO_EXPRESSIONS_impl_H
 #define MICO_EXPRESSIONS_impl_H
 
+#include <memory>
 #include "mico/ast.h"
 
+namespace mico { namespace objects {
+    class base;
+}}
+
 namespace mico { namespace ast { namespace expressions {
 
     template <type>
     class impl;
 
+    /// the object of a literal; the evaluator makes it once and gives it
+    /// to everybody, such objects are never changed in place
+    class literal_object {
+
+    public:
+
+        using object_sptr = mico::shared_ptr<objects::base>;
+
+        const object_sptr &object( ) const
+        {
+            return object_;
+        }
+
+        void set_object( object_sptr val ) const
+        {
+            object_ = std::move(val);
+        }
+
+    protected:
+        mutable object_sptr object_;
+    };
+
 }}}
 
 #endif // impl_H
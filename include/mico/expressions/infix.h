@@ -71,6 +71,16 @@ namespace mico { namespace ast { namespace expressions {
             return token_;
         }
 
+        ast::quick quick_kind( ) const
+        {
+            return quick_;
+        }
+
+        void set_quick( ast::quick val )
+        {
+            quick_ = val;
+        }
+
         void mutate( mutator_type call ) override
         {
             ast::node::apply_mutator( left_, call );
@@ -93,6 +103,7 @@ namespace mico { namespace ast { namespace expressions {
         tokens::type    token_;
         node::uptr      left_;
         node::uptr      right_;
+        ast::quick      quick_ = ast::quick::UNKNOWN;
     };
 
     using infix = impl<type::INFIX>;
@@ -0,0 +1,124 @@
+#ifndef MICO_EXPRESSION_LAZY_H
+#define MICO_EXPRESSION_LAZY_H
+
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "mico/ast.h"
+#include "mico/expressions/impl.h"
+#include "mico/expressions/list.h"
+
+namespace mico { namespace ast { namespace expressions {
+
+    /// A function body that is not parsed yet.
+    /// The parser keeps only the text of the body; it is parsed the first
+    /// time somebody needs the tree. Passes that walk the program before
+    /// that (macros, the resolver) leave their work here and it is done
+    /// right after the parsing in the same order.
+    template <>
+    class impl<type::LAZY>: public typed_expr<type::LAZY> {
+
+        using this_type = impl<type::LAZY>;
+
+    public:
+
+        using uptr       = std::unique_ptr<this_type>;
+        using error_list = std::vector<std::string>;
+        using parse_call = std::function<ast::node::uptr (error_list &)>;
+        using pass_call  = std::function<void (ast::node::uptr &,
+                                               error_list &)>;
+
+        explicit
+        impl<type::LAZY>( parse_call parse )
+            :parse_(std::move(parse))
+        { }
+
+        static
+        uptr make( parse_call parse )
+        {
+            return uptr(new this_type( std::move(parse) ) );
+        }
+
+        bool ready( ) const
+        {
+            return body_ != nullptr;
+        }
+
+        /// the body; an empty scope if it has errors
+        const ast::node::uptr &get( ) const
+        {
+            if( !body_ ) {
+                body_ = parse_( errors_ );
+                if( !body_ ) {
+                    auto empty = list::make_scope( );
+                    empty->set_pos( pos( ) );
+                    body_ = std::move(empty);
+                }
+                for( auto &p: passes_ ) {
+                    if( errors_.empty( ) ) {
+                        p( body_, errors_ );
+                    }
+                }
+                passes_.clear( );
+                parse_ = nullptr;
+            }
+            return body_;
+        }
+
+        const error_list &errors( ) const
+        {
+            get( );
+            return errors_;
+        }
+
+        /// 'pass' is called with the body when it is parsed
+        void defer( pass_call pass )
+        {
+            if( body_ ) {
+                pass( body_, errors_ );
+            } else {
+                passes_.emplace_back( std::move(pass) );
+            }
+        }
+
+        std::string str( ) const override
+        {
+            return get( )->str( );
+        }
+
+        void mutate( mutator_type call ) override
+        {
+            get( );
+            ast::node::apply_mutator( body_, call );
+        }
+
+        bool is_const( ) const override
+        {
+            return get( )->is_const( );
+        }
+
+        ast::node::uptr clone( ) const override
+        {
+            if( body_ ) {
+                return node::call_clone( body_ );
+            }
+            uptr res(new this_type( parse_ ));
+            res->passes_ = passes_;
+            res->set_pos( pos( ) );
+            return ast::node::uptr( std::move(res) );
+        }
+
+    private:
+
+        mutable parse_call              parse_;
+        mutable std::vector<pass_call>  passes_;
+        mutable ast::node::uptr         body_;
+        mutable error_list              errors_;
+    };
+
+    using lazy = impl<type::LAZY>;
+
+}}}
+
+#endif // MICO_EXPRESSION_LAZY_H
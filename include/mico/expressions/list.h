@@ -5,6 +5,7 @@
 #include <deque>
 #include "mico/ast.h"
 #include "mico/tokens.h"
+#include "mico/layout.h"
 #include "mico/expressions/impl.h"
 
 namespace mico { namespace ast { namespace expressions {
@@ -49,6 +50,17 @@ namespace mico { namespace ast { namespace expressions {
             return scope_;
         }
 
+        /// names bound in the environment that evaluates this list
+        const layout::sptr &get_layout( ) const
+        {
+            return layout_;
+        }
+
+        void set_layout( layout::sptr val )
+        {
+            layout_ = std::move(val);
+        }
+
         list_type &value( )
         {
             return value_;
@@ -113,6 +125,7 @@ namespace mico { namespace ast { namespace expressions {
         {
             uptr res(new this_type(scope_));
             res->set_pos( pos( ) );
+            res->layout_ = layout_;
             for( auto &v: value_ ) {
                 res->value_.emplace_back( ast::node::call_clone( v ) );
             }
@@ -163,6 +176,7 @@ namespace mico { namespace ast { namespace expressions {
     private:
         list_type value_;
         role scope_ = role::LIST_SCOPE;
+        layout::sptr layout_;
     };
 
     using list = impl<type::LIST>;
@@ -82,7 +82,8 @@ namespace mico { namespace ast { namespace expressions {
 
         ast::node::uptr clone( ) const override
         {
-            uptr res(new this_type( name_->clone( ), parents_->clone_me( ) ) );
+            uptr res(new this_type( node::call_clone( name_ ),
+                                    parents_->clone_me( ) ) );
             res->body_    = ast::node::call_clone( body_ );
             res->parents_ = parents_->clone_me( );
             return ast::node::uptr( std::move( res ) );
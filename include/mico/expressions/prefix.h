@@ -42,6 +42,16 @@ namespace mico { namespace ast { namespace expressions {
             return token_;
         }
 
+        ast::quick quick_kind( ) const
+        {
+            return quick_;
+        }
+
+        void set_quick( ast::quick val )
+        {
+            quick_ = val;
+        }
+
         void mutate( mutator_type call ) override
         {
             ast::node::apply_mutator( expr_, call );
@@ -60,6 +70,7 @@ namespace mico { namespace ast { namespace expressions {
     private:
         tokens::type token_;
         node::uptr   expr_;
+        ast::quick   quick_ = ast::quick::UNKNOWN;
     };
 
     using prefix = impl<type::PREFIX>;
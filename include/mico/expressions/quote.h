@@ -56,7 +56,7 @@ namespace mico { namespace ast { namespace expressions {
 
         ast::node::uptr clone( ) const override
         {
-            return make( value_->clone( ) );
+            return make( node::call_clone( value_ ) );
         }
 
         bool is_const( ) const override
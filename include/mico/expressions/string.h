@@ -9,7 +9,8 @@
 namespace mico { namespace ast { namespace expressions {
 
     template <>
-    class impl<type::STRING>: public typed_expr<type::STRING> {
+    class impl<type::STRING>: public typed_expr<type::STRING>,
+                              public literal_object {
 
         using this_type = impl<type::STRING>;
     public:
@@ -44,6 +45,7 @@ namespace mico { namespace ast { namespace expressions {
 
         std::string &value( )
         {
+            object_.reset( );
             return value_;
         }
 
@@ -71,7 +73,9 @@ namespace mico { namespace ast { namespace expressions {
 
         ast::node::uptr clone( ) const override
         {
-            return uptr( new this_type(value_, raw_ ) );
+            uptr res( new this_type(value_, raw_ ) );
+            res->object_ = object_;
+            return ast::node::uptr( std::move(res) );
         }
 
     private:
@@ -9,7 +9,7 @@
 namespace mico { namespace ast { namespace expressions {
 
     template <type TN, typename ValueT>
-    class value_expr: public typed_expr<TN> {
+    class value_expr: public typed_expr<TN>, public literal_object {
 
     public:
 
@@ -61,7 +61,9 @@ namespace mico { namespace ast { namespace expressions {
 
         ast::node::uptr clone( ) const override
         {
-            return make(value( ));
+            auto res = make(value( ));
+            res->object_ = object_;
+            return ast::node::uptr( std::move(res) );
         }
 
         static
@@ -85,7 +87,9 @@ namespace mico { namespace ast { namespace expressions {
 
         ast::node::uptr clone( ) const override
         {
-            return uptr(new this_type(value( ) ) );
+            uptr res(new this_type(value( ) ) );
+            res->object_ = object_;
+            return ast::node::uptr( std::move(res) );
         }
 
         static
@@ -1,6 +1,12 @@
 #ifndef MICO_IDENTS_H
 #define MICO_IDENTS_H
 
+#include <cstdint>
+
+#if defined(__SSE2__)
+#   include <emmintrin.h>
+#endif
+
 #include "mico/numeric.h"
 
 namespace mico {
@@ -51,6 +57,94 @@ namespace mico {
                || (static_cast<std::uint8_t>(c) > 127);
         }
 
+        /// runs of characters; 16 at a time where SSE2 is there
+
+        static
+        const char *skip_idents( const char *b, const char *end )
+        {
+#if defined(__SSE2__)
+            const auto zero  = _mm_setzero_si128( );
+            const auto lower = _mm_set1_epi8( 0x20 );
+            while( end - b >= 16 ) {
+                auto c  = _mm_loadu_si128(
+                                reinterpret_cast<const __m128i *>( b ) );
+                auto lc = _mm_or_si128( c, lower );
+                auto ok = _mm_or_si128(
+                    _mm_or_si128( _mm_cmplt_epi8( c, zero ),
+                                  _mm_cmpeq_epi8( c, _mm_set1_epi8( '_' ) ) ),
+                    _mm_or_si128( in_range( c,  '0', '9' ),
+                                  in_range( lc, 'a', 'z' ) ) );
+                auto mask = ~_mm_movemask_epi8( ok ) & 0xFFFF;
+                if( mask ) {
+                    return b + __builtin_ctz( mask );
+                }
+                b += 16;
+            }
+#endif
+            while( b != end && is_ident( *b ) ) {
+                ++b;
+            }
+            return b;
+        }
+
+        static
+        const char *skip_whitespaces( const char *b, const char *end )
+        {
+#if defined(__SSE2__)
+            while( end - b >= 16 ) {
+                auto c  = _mm_loadu_si128(
+                                reinterpret_cast<const __m128i *>( b ) );
+                auto ok = _mm_or_si128(
+                                _mm_cmpeq_epi8( c, _mm_set1_epi8( ' ' ) ),
+                                _mm_cmpeq_epi8( c, _mm_set1_epi8( '\t' ) ) );
+                auto mask = ~_mm_movemask_epi8( ok ) & 0xFFFF;
+                if( mask ) {
+                    return b + __builtin_ctz( mask );
+                }
+                b += 16;
+            }
+#endif
+            while( b != end && is_whitespace( *b ) ) {
+                ++b;
+            }
+            return b;
+        }
+
+        static
+        const char *skip_line( const char *b, const char *end )
+        {
+#if defined(__SSE2__)
+            while( end - b >= 16 ) {
+                auto c  = _mm_loadu_si128(
+                                reinterpret_cast<const __m128i *>( b ) );
+                auto nl = _mm_or_si128(
+                                _mm_cmpeq_epi8( c, _mm_set1_epi8( '\n' ) ),
+                                _mm_cmpeq_epi8( c, _mm_set1_epi8( '\r' ) ) );
+                auto mask = _mm_movemask_epi8( nl );
+                if( mask ) {
+                    return b + __builtin_ctz( mask );
+                }
+                b += 16;
+            }
+#endif
+            while( b != end && !is_newline( *b ) ) {
+                ++b;
+            }
+            return b;
+        }
+
+    private:
+
+#if defined(__SSE2__)
+        static
+        __m128i in_range( __m128i c, char lo, char hi )
+        {
+            auto above = _mm_cmpgt_epi8( c, _mm_set1_epi8( lo - 1 ) );
+            auto below = _mm_cmplt_epi8( c, _mm_set1_epi8( hi + 1 ) );
+            return _mm_and_si128( above, below );
+        }
+#endif
+
     };
 }
 
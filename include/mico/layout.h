@@ -0,0 +1,81 @@
+#ifndef MICO_LAYOUT_H
+#define MICO_LAYOUT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace mico {
+
+    /// Names that are bound in one lexical scope.
+    /// The resolver builds it; an environment created with a layout
+    /// keeps these names in a slot vector instead of the map.
+    class layout {
+
+    public:
+
+        using sptr = std::shared_ptr<layout>;
+        using name_list = std::vector<std::string>;
+
+        static const std::size_t npos = static_cast<std::size_t>(-1);
+
+        static
+        sptr make( )
+        {
+            return std::make_shared<layout>( );
+        }
+
+        std::size_t find( const std::string &name ) const
+        {
+            if( !index_.empty( ) ) {
+                auto f = index_.find( name );
+                return f == index_.end( ) ? npos : f->second;
+            }
+            for( std::size_t i = 0; i < names_.size( ); ++i ) {
+                if( names_[i] == name ) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+
+        std::size_t add( const std::string &name )
+        {
+            auto id = find( name );
+            if( id == npos ) {
+                id = names_.size( );
+                names_.push_back( name );
+                if( !index_.empty( ) ) {
+                    index_.emplace( name, id );
+                } else if( names_.size( ) > index_after ) {
+                    for( std::size_t i = 0; i < names_.size( ); ++i ) {
+                        index_.emplace( names_[i], i );
+                    }
+                }
+            }
+            return id;
+        }
+
+        std::size_t size( ) const
+        {
+            return names_.size( );
+        }
+
+        const name_list &names( ) const
+        {
+            return names_;
+        }
+
+    private:
+
+        /// small scopes are faster to scan
+        static const std::size_t index_after = 16;
+
+        name_list                                    names_;
+        std::unordered_map<std::string, std::size_t> index_;
+    };
+
+}
+
+#endif // MICO_LAYOUT_H
@@ -2,11 +2,13 @@
 #define MICO_LEXER_H
 
 #include <vector>
+#include <deque>
 #include <map>
 #include <sstream>
 
-#include "etool/trees/trie/base.h"
 #include "mico/tokens.h"
+#include "mico/source.h"
+#include "mico/token_names.h"
 #include "mico/numeric.h"
 #include "mico/idents.h"
 
@@ -15,126 +17,53 @@ namespace mico {
     struct lexer {
 
         using token_type  = tokens::type;
-        using token_trie  = etool::trees::trie::base<char, token_type>;
         using token_ident = tokens::type_ident;
         using token_info  = tokens::info;
         using token_list  = std::vector<token_info>;
         using error_list  = std::vector<std::string>;
+        using string_list = std::deque<std::string>;
 
         struct state {
 
-            explicit
-            state( std::string::const_iterator b )
+            state( const char *b, string_list *s )
                 :line_itr(b)
                 ,begin_itr(b)
+                ,strings(s)
             { }
             std::size_t line = 1;
-            std::string::const_iterator line_itr;
-            std::string::const_iterator begin_itr;
+            const char *line_itr;
+            const char *begin_itr;
+            string_list *strings;
         };
 
     //private:
 
         static
-        void add_token( token_trie &ttrie, std::string value, token_type tt )
+        const char *skip_whitespaces( const char *b, const char *end )
         {
-            ttrie.set( value, tt );
+            return idents::skip_whitespaces( b, end );
         }
 
         static
-        void add_token( token_trie &ttrie, int tt_int )
+        const char *skip_comment( const char *b, const char *end )
         {
-            auto tt = static_cast<token_type>(tt_int);
-            std::string name = tokens::name::get( tt );
-            add_token( ttrie, name, tt );
+            return idents::skip_line( b, end );
         }
 
         static
-        token_trie make_trie(  )
-        {
-            auto begin = static_cast<int>(tokens::type::FIRST_VISIBLE);
-            const auto end = static_cast<int>(tokens::type::LAST_VISIBLE);
-
-            token_trie res;
-            for( ++begin; begin != end; ++begin ) {
-                add_token( res, begin );
-            }
-
-            add_token( res, "0b",   tokens::type::INT_BIN );
-            add_token( res, "0B",   tokens::type::INT_BIN );
-
-            add_token( res, "0t",   tokens::type::INT_TER );
-            add_token( res, "0T",   tokens::type::INT_TER );
-
-            add_token( res, "0x",   tokens::type::INT_HEX );
-            add_token( res, "0X",   tokens::type::INT_HEX );
-
-            add_token( res, "0",    tokens::type::INT_OCT );
-            add_token( res, "0o",   tokens::type::INT_OCT );
-            add_token( res, "0O",   tokens::type::INT_OCT );
-
-            add_token( res, "\"",   tokens::type::STRING );
-            add_token( res, "r\"",  tokens::type::RSTRING );
-            add_token( res, "R\"",  tokens::type::RSTRING );
-            add_token( res, "'",    tokens::type::CHARACTER );
-
-            add_token( res, "\n",   tokens::type::END_OF_LINE );
-            add_token( res, "\r\n", tokens::type::END_OF_LINE );
-            add_token( res, "\n\r", tokens::type::END_OF_LINE );
-
-            add_token( res, "//",   tokens::type::COMMENT);
-
-            add_token( res, "λ",    tokens::type::FUNCTION );
-            add_token( res, "←",    tokens::type::LARROW );
-            add_token( res, "→",    tokens::type::RARROW );
-
-            return res;
-        }
-
-        template <typename ItrT>
-        static ItrT skip_whitespaces( ItrT b, ItrT end )
+        tokens::view read_number( const char *&begin, const char *end )
         {
-            while( b != end ) {
-                if( idents::is_newline(*b) ) {
-                    break;
-                } else if( !idents::is_whitespace(*b) ) {
-                    break;
-                } else {
-                    ++b;
-                }
-            }
-            return b;
-        }
-
-        template <typename ItrT>
-        static ItrT skip_comment( ItrT b, ItrT end, state * /*lstate*/  )
-        {
-            while( b != end && !idents::is_newline(*b) ) {
-                ++b;
-            }
-            return b;
-        }
-
-        template <typename ItrT>
-        static
-        std::string read_number( ItrT &begin, ItrT end )
-        {
-            std::string res;
-
-            for( ; begin != end; ++begin ) {
-                if( numeric::valid_for_hex_( *begin ) ) {
-                    res.push_back( *begin );
-                } else {
-                    break;
-                }
+            auto start = begin;
+            while( begin != end && numeric::valid_for_hex_( *begin ) ) {
+                ++begin;
             }
-
-            return res;
+            return tokens::view( start, begin - start );
         }
 
         template <typename ItrT>
         static
-        std::string read_string( ItrT &begin, ItrT end, state *lstate, char c )
+        std::string decode_string( ItrT &begin, ItrT end, state *lstate,
+                                   char c )
         {
             std::string res;
             for( ; (begin != end) && (*begin != c); ++begin ) {
@@ -193,241 +122,353 @@ namespace mico {
             return res;
         }
 
-        template <typename ItrT>
+        /// a view when the string has no escapes, the decoded copy otherwise
         static
-        std::string read_ident( ItrT &begin, ItrT end )
+        tokens::view keep( state *lstate, std::string value )
         {
-            std::string res;
+            lstate->strings->emplace_back( std::move(value) );
+            auto &last( lstate->strings->back( ) );
+            return tokens::view( last.data( ), last.size( ) );
+        }
 
-            for( ; begin != end; ++begin ) {
-                if( idents::is_ident( *begin ) ) {
-                    res.push_back( *begin );
-                } else {
-                    break;
+        static
+        token_ident read_string( token_type tt, const char *&begin,
+                                 const char *end, state *lstate, char c )
+        {
+            auto start = begin;
+            auto saved = *lstate;
+            for( ; (begin != end) && (*begin != c); ++begin ) {
+                if( *begin == '\\' ) {
+                    begin   = start;
+                    *lstate = saved;
+                    auto value = decode_string( begin, end, lstate, c );
+                    return token_ident( tt, keep( lstate, std::move(value) ) );
+                } else if( *begin == '\n' ) {
+                    lstate->line++;
+                    lstate->line_itr = begin + 1;
                 }
             }
-
+            token_ident res( tt, tokens::view( start, begin - start ) );
+            if( begin != end ) {
+                ++begin;
+            }
             return res;
         }
 
-        template <typename ItrT>
         static
-        std::string read_float( ItrT &begin, ItrT end, int *found )
+        tokens::view read_ident( const char *&begin, const char *end )
         {
-            std::string res;
-            *found = 0;
-            auto chk = &idents::is_digit;
+            auto start = begin;
+            begin = idents::skip_idents( begin, end );
+            return tokens::view( start, begin - start );
+        }
 
-            for( ;begin != end; ++begin ) {
-                if( chk( *begin ) ) {
-                    res.push_back( *begin );
-                } else if( !numeric::is_gap(*begin) ) {
-                    break;
-                }
-            }
+        /// a view when there are no gaps, '1_000.5' is kept as '1000.5'
+        static
+        token_ident read_float( const char *&begin, const char *end,
+                                state *lstate )
+        {
+            auto start = begin;
+            bool gaps  = false;
+            auto chk   = &idents::is_digit;
 
-            if( begin != end && *begin == '.' ) {
-                res.push_back( *begin++ );
-                *found = 1;
+            auto digits = [&]( ) {
                 for( ;begin != end; ++begin ) {
-                    if( chk( *begin ) ) {
-                        res.push_back( *begin );
-                    } else if( !numeric::is_gap(*begin) ) {
+                    if( numeric::is_gap( *begin ) ) {
+                        gaps = true;
+                    } else if( !chk( *begin ) ) {
                         break;
                     }
                 }
+            };
+
+            digits( );
+
+            if( begin != end && *begin == '.' ) {
+                ++begin;
+                digits( );
             }
 
             if( begin != end && (*begin == 'e' || *begin == 'E') ) {
-                res.push_back( *begin++ );
-                *found = 1;
+                ++begin;
                 if( begin != end && (*begin == '+' || *begin == '-') ) {
-                    res.push_back( *begin++ );
+                    ++begin;
                 }
-                for( ;begin != end; ++begin ) {
-                    if( chk( *begin ) ) {
-                        res.push_back( *begin );
-                    } else if( !numeric::is_gap(*begin) ) {
-                        break;
-                    }
+                digits( );
+            }
+
+            tokens::view res( start, begin - start );
+            if( !gaps ) {
+                return token_ident( token_type::FLOAT, res );
+            }
+
+            std::string value;
+            for( auto c: res ) {
+                if( !numeric::is_gap( c ) ) {
+                    value.push_back( c );
                 }
             }
+            return token_ident( token_type::FLOAT,
+                                keep( lstate, std::move(value) ) );
+        }
 
-            return res;
+        static
+        token_type number_prefix( char c )
+        {
+            switch( c ) {
+            case 'b': case 'B': return token_type::INT_BIN;
+            case 't': case 'T': return token_type::INT_TER;
+            case 'x': case 'X': return token_type::INT_HEX;
+            case 'o': case 'O': return token_type::INT_OCT;
+            }
+            return token_type::NONE;
+        }
+
+        static
+        std::pair<token_ident, const char *> read_decimal( const char *begin,
+                                                          const char *end,
+                                                          state *lstate )
+        {
+            if( numeric::check_if_float( begin, end ) ) {
+                auto value = read_float( begin, end, lstate );
+                return std::make_pair( value, begin );
+            }
+            token_ident value( token_type::INT_DEC,
+                               read_number( begin, end ) );
+            return std::make_pair( value, begin );
         }
 
-        template <typename ItrT>
         static
-        std::pair<token_ident, ItrT> next_noken( ItrT begin, ItrT end,
-                                                 token_trie  &ttrie,
-                                                 state *lstate )
+        std::pair<token_ident, const char *> next_noken( const char *begin,
+                                                        const char *end,
+                                                        state *lstate )
         {
             using I = token_ident;
 
-            while( begin != end ) {
+            if( begin == end ) {
+                return std::make_pair( I(token_type::END_OF_FILE), end );
+            }
 
-                auto bb   = begin;
-                token_ident value;
-                auto next = ttrie.get(begin, end, true);
+            auto bb   = begin;
+            auto next = begin + 1;
+            char c    = *begin;
 
-                value.name = token_type::NONE;
-                int ffound = 0;
+            if( idents::is_digit( c ) ) {
+                auto tt = ( c == '0' && next != end )
+                        ? number_prefix( *next )
+                        : token_type::NONE;
+                if( tt == token_type::NONE ) {
+                    return read_decimal( begin, end, lstate );
+                }
+                bb = next + 1;
+                I value( tt, read_number( bb, end ) );
+                return std::make_pair( value, bb );
+            }
 
-                if( next ) {
+            if( (c == 'r' || c == 'R') && next != end && *next == '"' ) {
+                bb = next + 1;
+                auto value = read_string( token_type::RSTRING, bb, end,
+                                          lstate, '"' );
+                return std::make_pair( value, bb );
+            }
 
-                    auto tt = *next;
-                    value = token_ident(*next);
+            auto &symbols( token_names::symbols( ) );
 
-                    /// fix situation whan we get `let1` for example
-                    /// `let1` is an ident and is not a keyword
-                    if( next.iterator( ) != end ) {
-                        if( (tt >= token_type::LET) &&
-                            (tt < token_type::LAST_VISIBLE ) ) {
-                            if( idents::is_ident( *bb ) &&
-                                idents::is_ident( *(next.iterator( )) ) ) {
-                                tt = token_type::IDENT;
-                            }
-                        }
+            if( idents::is_ident( c ) ) {
+                /// '←' and '→' are made of the bytes of identifiers
+                if( static_cast<std::uint8_t>( c ) > 127 ) {
+                    auto tt = symbols.match( begin, end, &next );
+                    if( tt != token_type::NONE ) {
+                        return std::make_pair( I(tt), next );
                     }
+                }
+                auto word = read_ident( bb, end );
+                auto tt = token_names::words( ).find( word.ptr, word.size );
+                if( tt == token_type::NONE ) {
+                    return std::make_pair( I(token_type::IDENT, word), bb );
+                }
+                return std::make_pair( I(tt), bb );
+            }
 
-                    switch( tt ) {
-                    case token_type::COMMENT:
-                        bb = skip_comment( next.iterator( ), end, lstate );
-                        value.literal = "";
-                        return std::make_pair( std::move(value), bb );
-                    case token_type::END_OF_LINE:
-                        lstate->line++;
-                        lstate->line_itr = next.iterator( );
-                        return std::make_pair( std::move(value),
-                                               next.iterator( ) );
-                    case token_type::INT_BIN:
-                    case token_type::INT_TER:
-                    case token_type::INT_HEX:
-                        bb = next.iterator( );
-                        value.literal = read_number( bb, end );
-                        return std::make_pair( std::move(value), bb );
-                    case token_type::INT_OCT:
-                        bb = std::prev(next.iterator( ));
-
-                        if( numeric::check_if_float( bb, end ) ) {
-                            value.name = token_type::FLOAT;
-                            value.literal = read_float(bb, end, &ffound );
-                        } else {
-                            value.name = token_type::INT_DEC;
-                            value.literal = read_number(bb, end );
-                        }
-                        return std::make_pair( std::move(value), bb );
-
-                    case token_type::DOT:
-                        bb = std::prev(next.iterator( ));
-                        if( idents::is_digit( *next.iterator( ) ) ) {
-                            value.name = token_type::FLOAT;
-                            value.literal = read_float(bb, end, &ffound );
-                            return std::make_pair( std::move(value), bb );
-                        } else {
-                            return std::make_pair( std::move(value),
-                                                   next.iterator( ) );
-                        }
-                    case token_type::IDENT:
-                        value.name    = token_type::IDENT;
-                        value.literal = read_ident( bb, end  );
-                        return std::make_pair( std::move(value), bb );
-                    case token_type::STRING:
-                    case token_type::RSTRING:
-                        bb = next.iterator( );
-                        value.literal = read_string( bb, end, lstate, '"' );
-                        return std::make_pair( std::move(value), bb );
-                    case token_type::CHARACTER:
-                        bb = next.iterator( );
-                        value.literal = read_string( bb, end, lstate, '\'' );
-                        return std::make_pair( std::move(value), bb );
-                    default:
-                        return std::make_pair( std::move(value),
-                                               next.iterator( ) );
-                    }
-                    //begin = next.iterator( );
-                } else if( idents::is_digit( *bb ) ) {
-                    if( numeric::check_if_float( bb, end ) ) {
-                        value.name = token_type::FLOAT;
-                        value.literal = read_float(bb, end, &ffound );
-                    } else {
-                        value.name = token_type::INT_DEC;
-                        value.literal = read_number(bb, end );
-                    }
-                    return std::make_pair( std::move(value), bb );
+            auto tt = symbols.match( begin, end, &next );
+            switch( tt ) {
+            case token_type::COMMENT:
+                return std::make_pair( I(tt, tokens::view( )),
+                                       skip_comment( next, end ) );
+            case token_type::END_OF_LINE:
+                lstate->line++;
+                lstate->line_itr = next;
+                return std::make_pair( I(tt), next );
+            case token_type::DOT:
+                if( next != end && idents::is_digit( *next ) ) {
+                    auto value = read_float( bb, end, lstate );
+                    return std::make_pair( value, bb );
+                }
+                return std::make_pair( I(tt), next );
+            case token_type::STRING:
+            case token_type::CHARACTER:
+                bb = next;
+                return std::make_pair( read_string( tt, bb, end, lstate, c ),
+                                       bb );
+            case token_type::NONE:
+                return std::make_pair( I(tt), begin );
+            default:
+                break;
+            }
+            return std::make_pair( I(tt), next );
+        }
 
-                } else if( idents::is_ident(*bb) ) {
-                    //// TODO: fix COPY-PASTE ...
-                    value.name    = token_type::IDENT;
-                    value.literal = read_ident( bb, end  );
-                    return std::make_pair( std::move(value), bb );
-                } else {
-                    return std::make_pair( I(token_type::NONE), begin );
+    public:
+
+        /// tokens one by one, the parser takes the next one when it needs
+        /// it. Views of the tokens stay valid while the stream or a lexer
+        /// made from it lives.
+        class stream {
+
+        public:
+
+            using string_ptr = std::shared_ptr<string_list>;
+
+            explicit
+            stream( source::sptr src )
+                :source_(std::move(src))
+                ,strings_(std::make_shared<string_list>( ))
+                ,state_(source_->begin( ), strings_.get( ))
+                ,cur_(skip_whitespaces( source_->begin( ), source_->end( ) ))
+                ,end_(source_->end( ))
+            { }
+
+            /// [begin, end) of 'src'; 'line' and 'line_begin' tell where
+            /// 'begin' is in the whole text
+            stream( source::sptr src, const char *begin, const char *end,
+                    std::size_t line, const char *line_begin )
+                :source_(std::move(src))
+                ,strings_(std::make_shared<string_list>( ))
+                ,state_(line_begin, strings_.get( ))
+                ,cur_(skip_whitespaces( begin, end ))
+                ,end_(end)
+            {
+                state_.line = line;
+            }
+
+            /// END_OF_FILE at the end and every time after it.
+            /// The first unexpected symbol ends the stream for the parser,
+            /// 'drain' finds the rest of the errors
+            token_info next( )
+            {
+                if( !errors_.empty( ) ) {
+                    return eof( );
                 }
+                return read( );
             }
 
-            return std::make_pair( I(token_type::END_OF_FILE), end);
-        }
+            void drain( )
+            {
+                while( read( ).ident.name != token_type::END_OF_FILE );
+            }
 
-        template <typename ItrT>
-        void push_error( const state &st, ItrT cur )
-        {
-            std::ostringstream oss;
-            oss << st.line << ":" << std::distance(st.line_itr, cur)
-                << " Unexpected symbol '" << *cur << "'";
+            const error_list &errors( ) const
+            {
+                return errors_;
+            }
 
-            errors_.emplace_back( oss.str( ) );
-        }
+            const source::sptr &get_source( ) const
+            {
+                return source_;
+            }
 
-    public:
+            const string_ptr &strings( ) const
+            {
+                return strings_;
+            }
 
-        static
-        lexer make( const std::string &input )
-        {
-            auto ttrie = make_trie( );
+        private:
 
-            state lex_state(input.begin( ));
-            lexer res;
+            token_info read( )
+            {
+                const auto end = end_;
 
-            auto b = input.begin( );
+                while( cur_ != end ) {
 
-            b = skip_whitespaces( b, input.end( ) );
+                    auto bb           = cur_;
+                    auto line_start   = state_.line_itr;
+                    auto current_line = state_.line;
 
-            while( b != input.end( ) ) {
+                    auto nt = next_noken( cur_, end, &state_ );
+                    cur_ = nt.second;
 
-                auto bb = b;
+                    if( nt.first.name == token_type::END_OF_FILE ) {
+                        break;
+                    } else if( nt.first.name == token_type::NONE ) {
+                        push_error( bb );
+                        ++cur_;
+                    } else if( nt.first.name != token_type::END_OF_LINE &&
+                               nt.first.name != token_type::COMMENT ) {
+                        token_info ti;
+                        ti.ident      = nt.first;
+                        ti.where.line = current_line;
+                        ti.where.pos  = std::distance( line_start, bb );
+                        ti.begin      = bb;
+                        cur_ = skip_whitespaces( cur_, end );
+                        return ti;
+                    }
+                    cur_ = skip_whitespaces( cur_, end );
+                }
+                return eof( );
+            }
+
+            token_info eof( ) const
+            {
                 token_info ti;
-                auto line_start = lex_state.line_itr;
-                auto current_line = lex_state.line;
-
-                auto nt = next_noken( b, input.end( ), ttrie, &lex_state );
-
-                if( nt.first.name == token_type::END_OF_FILE ) {
-                    break;
-                } else if( nt.first.name == token_type::END_OF_LINE ) {
-                    // do nothing yet
-                } else if ( nt.first.name == token_type::COMMENT ) {
-                    /// do nothing
-                } else if( nt.first.name == token_type::NONE ) {
-                    res.push_error( lex_state, b );
-                    nt.second++;
-                } else {
+                ti.ident      = token_ident(token_type::END_OF_FILE);
+                ti.where.line = state_.line;
+                ti.where.pos  = std::distance( state_.line_itr, cur_ );
+                ti.begin      = cur_;
+                return ti;
+            }
 
-                    ti.ident      = std::move(nt.first);
-                    ti.where.line = current_line;
-                    ti.where.pos  = std::distance( line_start, bb );
+            void push_error( const char *cur )
+            {
+                std::ostringstream oss;
+                oss << state_.line << ":" << std::distance(state_.line_itr, cur)
+                    << " Unexpected symbol '" << *cur << "'";
 
-                    res.tokens_.emplace_back(std::move(ti));
-                }
-                b = skip_whitespaces( nt.second, input.end( ) );
+                errors_.emplace_back( oss.str( ) );
             }
 
-            token_info ti;
-            ti.ident      = token_ident(token_type::END_OF_FILE);
-            ti.where.line = lex_state.line;
-            ti.where.pos  = std::distance( lex_state.line_itr, b );
-            res.tokens_.emplace_back(std::move(ti));
+            source::sptr source_;
+            string_ptr   strings_;
+            state        state_;
+            const char  *cur_;
+            const char  *end_;
+            error_list   errors_;
+        };
 
+        static
+        lexer make( const std::string &input )
+        {
+            return make( source::make( input ) );
+        }
+
+        /// all tokens at once
+        static
+        lexer make( source::sptr src )
+        {
+            lexer res;
+            /// a token per 3-8 bytes usually; pages that are not
+            /// touched cost nothing, a reallocation copies everything
+            res.tokens_.reserve( src->size( ) / 2 + 1 );
+
+            stream tokens( std::move(src) );
+            do {
+                res.tokens_.emplace_back( tokens.next( ) );
+            } while( res.tokens_.back( ).ident.name
+                     != token_type::END_OF_FILE );
+            tokens.drain( );
+
+            res.source_  = tokens.get_source( );
+            res.strings_ = tokens.strings( );
+            res.errors_  = tokens.errors( );
             return res;
         }
 
@@ -447,8 +488,10 @@ namespace mico {
         }
 
     private:
-        token_list  tokens_;
-        error_list  errors_;
+        source::sptr        source_;
+        stream::string_ptr  strings_;
+        token_list          tokens_;
+        error_list          errors_;
     };
 
 }
@@ -70,19 +70,51 @@ namespace mico { namespace macro {
 
             void set( std::string name, ast::node::uptr value )
             {
+                flat_.reset( );
                 values_[name] = std::move(value);
             }
 
             void set_built( std::string name, built_in_macro::uptr value )
             {
+                flat_.reset( );
                 built_in_[name] = std::move(value);
             }
 
             void deny( std::string name )
             {
+                flat_.reset( );
                 remaped_.insert(name);
             }
 
+            /// a copy of the whole chain that does not need the parents;
+            /// for bodies that are processed when the chain is gone.
+            /// Parents do not change while the scope lives
+            std::shared_ptr<scope> flatten( )
+            {
+                if( flat_ ) {
+                    return flat_;
+                }
+                auto res = std::make_shared<scope>( );
+                for( scope *cur = this; cur; cur = cur->parent( ) ) {
+                    for( auto &v: cur->values_ ) {
+                        if( !res->values_.count( v.first ) ) {
+                            res->values_[v.first] =
+                                    ast::node::call_clone( v.second );
+                        }
+                    }
+                    for( auto &b: cur->built_in_ ) {
+                        if( !res->built_in_.count( b.first ) ) {
+                            auto copy = b.second->clone( ).release( );
+                            res->built_in_[b.first].reset(
+                                    static_cast<built_in_macro *>( copy ) );
+                        }
+                    }
+                }
+                res->remaped_ = remaped_;
+                flat_ = res;
+                return res;
+            }
+
             built_in_macro *get_built( const std::string &name )
             {
                 scope *cur = this;
@@ -133,6 +165,7 @@ namespace mico { namespace macro {
             value_map      values_;
             built_in_map   built_in_;
             remap_set      remaped_;
+            std::shared_ptr<scope> flat_;
         };
 
         static
@@ -293,6 +326,20 @@ namespace mico { namespace macro {
 
             } else if( n->get_type( ) == AT::QUOTE ) { // ignore quotes
                 return nullptr;
+            } else if( n->get_type( ) == AT::LAZY ) {
+                auto lz = ast::cast<AEX::lazy>( n );
+                if( !lz->ready( ) ) {
+                    auto flat = s->flatten( );
+                    lz->defer( [flat, ec]( ast::node::uptr &body,
+                                           error_list &errs ) {
+                        auto res = macro_mutator( body.get( ), flat.get( ),
+                                                  &errs, ec );
+                        if( res ) {
+                            body = std::move(res);
+                        }
+                    } );
+                    return nullptr;
+                }
             }
 //            else if( n->get_type( ) == AT::UNQUOTE ) {
 //                auto quo = ast::cast<ast::expressions::unquote>(n);
@@ -0,0 +1,947 @@
+#ifndef MICO_MICOC_H
+#define MICO_MICOC_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "mico/ast.h"
+#include "mico/expressions.h"
+#include "mico/statements.h"
+#include "mico/source.h"
+#include "mico/module_cache.h"
+
+#include "etool/details/result.h"
+
+namespace mico {
+
+    /// Programs that are parsed and macro-expanded, stored in a file.
+    /// A file is a header, a table of strings, the nodes in pre-order and
+    /// the positions of the nodes in the same order. Every string is
+    /// stored once. Fixed fields of the header are little-endian, all
+    /// other numbers are LEB128. The header keeps the size and the time
+    /// of the source, so a stale file is known without reading the source.
+    class micoc {
+
+        static const std::size_t header_size = 48;
+        static const std::uint64_t no_node   = 0xFF;
+
+    public:
+
+        using program_sptr = std::shared_ptr<ast::program>;
+        using load_result  = etool::details::result<program_sptr,
+                                                    std::string>;
+        using save_result  = etool::details::result<std::string,
+                                                    std::string>;
+
+        /// 2: the time of the source has nanoseconds
+        /// 3: identifiers keep their name in the source
+        static const std::uint16_t version = 3;
+
+        enum flag: std::uint16_t {
+            /// the file was made by a build with macros
+            MACROS          = 1,
+            /// the source has 'let name = macro(...)' on its top level;
+            /// the file lost them, exporters can not use it
+            DEFINES_MACROS  = 2,
+        };
+
+        static
+        const char *magic( )
+        {
+            return "MICOC\r\n";
+        }
+
+        /// script.mico -> script.micoc
+        static
+        std::string path_for( const std::string &path )
+        {
+            return path + "c";
+        }
+
+        static
+        bool is_compiled( const char *begin, const char *end )
+        {
+            auto size = static_cast<std::size_t>( end - begin );
+            return size >= header_size
+                && std::memcmp( begin, magic( ), 8 ) == 0;
+        }
+
+        /// the top level of the program defines macros
+        static
+        bool defines_macros( const ast::program *prog )
+        {
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+            for( auto &s: prog->states( ) ) {
+                if( s->get_type( ) == ast::type::PROGRAM ) {
+                    auto p = static_cast<const ast::program *>( s.get( ) );
+                    if( defines_macros( p ) ) {
+                        return true;
+                    }
+                } else if( s->get_type( ) == ast::type::LET ) {
+                    auto l = static_cast<const ast::statements::let *>
+                                                                ( s.get( ) );
+                    if( l->value( )->get_type( ) == ast::type::MACRO ) {
+                        return true;
+                    }
+                }
+            }
+#else
+            (void)(prog);
+#endif
+            return false;
+        }
+
+        /// 'src' is the stamp of the source the program was parsed from
+        static
+        save_result encode( ast::program *prog,
+                            const module_cache::stamp &src,
+                            bool macros_defined )
+        {
+            writer w;
+            w.uint( w.nodes, prog->states( ).size( ) );
+            for( auto &s: prog->states( ) ) {
+                if( !w.node( s.get( ) ) ) {
+                    return save_result::fail( w.error );
+                }
+            }
+
+            std::string strings;
+            w.uint( strings, w.strings.size( ) );
+            for( auto &s: w.strings ) {
+                w.uint( strings, s->size( ) );
+                strings.append( *s );
+            }
+
+            std::uint16_t flags = macros_defined ? DEFINES_MACROS : 0;
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+            flags |= MACROS;
+#endif
+            std::string res( magic( ), 8 );
+            put_fixed( res, version, 2 );
+            put_fixed( res, flags, 2 );
+            put_fixed( res, w.count, 4 );
+            put_fixed( res, src.size, 8 );
+            put_fixed( res, static_cast<std::uint64_t>( src.mtime ), 8 );
+            put_fixed( res, strings.size( ), 4 );
+            put_fixed( res, w.nodes.size( ), 4 );
+            put_fixed( res, w.positions.size( ), 4 );
+            put_fixed( res, 0, 4 );
+
+            res.append( strings );
+            res.append( w.nodes );
+            res.append( w.positions );
+            return save_result::ok( std::move(res) );
+        }
+
+        static
+        std::string save( ast::program *prog, const std::string &path,
+                          const module_cache::stamp &src,
+                          bool macros_defined )
+        {
+            auto data = encode( prog, src, macros_defined );
+            if( !data ) {
+                return data.error( );
+            }
+            std::ofstream f( path, std::ofstream::binary |
+                                   std::ofstream::trunc );
+            if( !f.is_open( ) ) {
+                return std::string("Unable to open file ") + path;
+            }
+            f.write( data->data( ), data->size( ) );
+            if( !f ) {
+                return std::string("Unable to write file ") + path;
+            }
+            return std::string( );
+        }
+
+        static
+        load_result decode( const char *begin, const char *end )
+        {
+            if( !is_compiled( begin, end ) ) {
+                return load_result::fail( "not a compiled program" );
+            }
+
+            auto head = begin + 8;
+            auto ver   = get_fixed( head, 2 );
+            auto flags = get_fixed( head + 2, 2 );
+            auto count = get_fixed( head + 4, 4 );
+            auto ssize = get_fixed( head + 24, 4 );
+            auto nsize = get_fixed( head + 28, 4 );
+            auto psize = get_fixed( head + 32, 4 );
+
+            if( ver != version ) {
+                return load_result::fail( "unsupported version" );
+            }
+#if defined(DISABLE_MACRO) && DISABLE_MACRO
+            if( flags & MACROS ) {
+                return load_result::fail( "made by a build with macros" );
+            }
+#else
+            (void)(flags);
+#endif
+            auto body = begin + header_size;
+            auto left = static_cast<std::uint64_t>( end - body );
+            if( ssize + nsize + psize != left ) {
+                return load_result::fail( "broken file" );
+            }
+
+            reader r( body, body + ssize );
+            r.nodes = { body + ssize, body + ssize + nsize };
+            r.positions = { body + ssize + nsize, end };
+            r.count = count;
+
+            if( !r.read_strings( ) ) {
+                return load_result::fail( "broken string table" );
+            }
+
+            auto res = std::make_shared<ast::program>( );
+            auto states = r.uint( r.nodes );
+            for( std::uint64_t i = 0; r.ok && i < states; ++i ) {
+                /// the macro processor leaves expressions on the top level
+                res->states( ).emplace_back( r.need( ) );
+            }
+
+            if( !r.ok || r.count != 0 ) {
+                return load_result::fail( "broken node table" );
+            }
+            return load_result::ok( res );
+        }
+
+        /// with 'src' the file is used only if it was made from that source
+        static
+        load_result load( const std::string &path,
+                          const module_cache::stamp *src = nullptr )
+        {
+            auto data = source::load( path );
+            if( !data ) {
+                return load_result::fail( data.error( ) );
+            }
+            auto b = (*data)->begin( );
+            auto e = (*data)->end( );
+            if( src && !fresh( b, e, *src ) ) {
+                return load_result::fail( "out of date" );
+            }
+            return decode( b, e );
+        }
+
+        static
+        bool fresh( const char *begin, const char *end,
+                    const module_cache::stamp &src )
+        {
+            if( !is_compiled( begin, end ) ) {
+                return false;
+            }
+            auto head  = begin + 8;
+            auto flags = get_fixed( head + 2, 2 );
+            return get_fixed( head, 2 ) == version
+                && ( flags & DEFINES_MACROS ) == 0
+                && get_fixed( head + 8, 8 ) == src.size
+                && get_fixed( head + 16, 8 )
+                        == static_cast<std::uint64_t>( src.mtime );
+        }
+
+    private:
+
+        static
+        void put_fixed( std::string &out, std::uint64_t val, std::size_t len )
+        {
+            for( std::size_t i = 0; i < len; ++i ) {
+                out.push_back( static_cast<char>( val & 0xFF ) );
+                val >>= 8;
+            }
+        }
+
+        static
+        std::uint64_t get_fixed( const char *ptr, std::size_t len )
+        {
+            std::uint64_t res = 0;
+            for( std::size_t i = len; i > 0; --i ) {
+                res = ( res << 8 ) | static_cast<std::uint8_t>( ptr[i - 1] );
+            }
+            return res;
+        }
+
+        struct writer {
+
+            void uint( std::string &out, std::uint64_t val )
+            {
+                while( val >= 0x80 ) {
+                    out.push_back( static_cast<char>( (val & 0x7F) | 0x80 ) );
+                    val >>= 7;
+                }
+                out.push_back( static_cast<char>( val ) );
+            }
+
+            static
+            std::uint64_t zigzag( std::int64_t val )
+            {
+                auto u = static_cast<std::uint64_t>( val );
+                return val < 0 ? ~(u << 1) : (u << 1);
+            }
+
+            void sint( std::string &out, std::int64_t val )
+            {
+                uint( out, zigzag( val ) );
+            }
+
+            void str( const std::string &val )
+            {
+                auto f = ids.find( val );
+                if( f == ids.end( ) ) {
+                    f = ids.emplace( val, strings.size( ) ).first;
+                    strings.push_back( &f->first );
+                }
+                uint( nodes, f->second );
+            }
+
+            /// 0 for a node without a position; a column step on the
+            /// same line; a line step and a column on a new line
+            void position( const tokens::position &pos )
+            {
+                auto line = static_cast<std::int64_t>( pos.line );
+                auto col  = static_cast<std::int64_t>( pos.pos );
+                if( line == 0 && col == 0 ) {
+                    uint( positions, 0 );
+                } else if( line == last_line ) {
+                    uint( positions, ( zigzag( col - last_col ) << 2 ) | 1 );
+                } else {
+                    uint( positions, ( zigzag( line - last_line ) << 2 ) | 2 );
+                    uint( positions, static_cast<std::uint64_t>( col ) );
+                }
+                if( line != 0 || col != 0 ) {
+                    last_line = line;
+                    last_col  = col;
+                }
+            }
+
+            bool fail( ast::node *n )
+            {
+                std::ostringstream oss;
+                oss << "[" << n->pos( ) << "] "
+                    << n->get_type( ) << " can not be stored";
+                error = oss.str( );
+                return false;
+            }
+
+            bool list( ast::node *n )
+            {
+                return n && n->get_type( ) == ast::type::LIST
+                     ? node( n )
+                     : fail( n );
+            }
+
+            bool node( ast::node *n )
+            {
+                using AT = ast::type;
+                namespace AST = ast::statements;
+                namespace AEX = ast::expressions;
+
+                if( !n ) {
+                    uint( nodes, no_node );
+                    return true;
+                }
+
+                /// bodies of the lazy mode are written parsed
+                if( n->get_type( ) == AT::LAZY ) {
+                    auto lz = ast::cast<AEX::lazy>( n );
+                    if( !lz->errors( ).empty( ) ) {
+                        error = lz->errors( ).front( );
+                        return false;
+                    }
+                    return node( lz->get( ).get( ) );
+                }
+
+                position( n->pos( ) );
+                ++count;
+
+                uint( nodes, static_cast<std::uint64_t>( n->get_type( ) ) );
+
+                bool res = true;
+                switch( n->get_type( ) ) {
+                case AT::PROGRAM: {
+                    auto p = ast::cast<ast::program>( n );
+                    uint( nodes, p->states( ).size( ) );
+                    for( auto &s: p->states( ) ) {
+                        res = res && node( s.get( ) );
+                    }
+                    break;
+                }
+                case AT::IDENT: {
+                    auto id = ast::cast<AEX::ident>( n );
+                    str( id->value( ) );
+                    str( id->name( ) );
+                    break;
+                }
+                case AT::LET: {
+                    auto l = ast::cast<AST::let>( n );
+                    uint( nodes, l->mut( ) ? 1 : 0 );
+                    res = node( l->ident( ).get( ) )
+                       && node( l->value( ).get( ) );
+                    break;
+                }
+                case AT::EXPR:
+                    res = node( ast::cast<AST::expr>( n )->value( ).get( ) );
+                    break;
+                case AT::RETURN:
+                    res = node( ast::cast<AST::ret>( n )->value( ) );
+                    break;
+                case AT::BREAK:
+                case AT::CONTINUE:
+                case AT::NONE:
+                    break;
+                case AT::PREFIX: {
+                    auto p = ast::cast<AEX::prefix>( n );
+                    uint( nodes, static_cast<std::uint64_t>( p->token( ) ) );
+                    res = node( p->value( ).get( ) );
+                    break;
+                }
+                case AT::INFIX: {
+                    auto i = ast::cast<AEX::infix>( n );
+                    uint( nodes, static_cast<std::uint64_t>( i->token( ) ) );
+                    res = node( i->left( ).get( ) )
+                       && node( i->right( ).get( ) );
+                    break;
+                }
+                case AT::STRING: {
+                    auto s = ast::cast<AEX::string>( n );
+                    uint( nodes, s->is_raw( ) ? 1 : 0 );
+                    str( s->value( ) );
+                    break;
+                }
+                case AT::CHARACTER:
+                    uint( nodes, ast::cast<AEX::character>( n )->value( ) );
+                    break;
+                case AT::INTEGER:
+                    sint( nodes, ast::cast<AEX::integer>( n )->value( ) );
+                    break;
+                case AT::BOOLEAN:
+                    uint( nodes, ast::cast<AEX::boolean>( n )->value( ) );
+                    break;
+                case AT::FLOAT: {
+                    double val = ast::cast<AEX::floating>( n )->value( );
+                    std::uint64_t bits;
+                    std::memcpy( &bits, &val, sizeof(bits) );
+                    put_fixed( nodes, bits, 8 );
+                    break;
+                }
+                case AT::INFIN:
+                    uint( nodes,
+                          ast::cast<AEX::infinite>( n )->is_negative( ) );
+                    break;
+                case AT::ARRAY: {
+                    auto a = ast::cast<AEX::array>( n );
+                    uint( nodes, a->value( ).size( ) );
+                    for( auto &v: a->value( ) ) {
+                        res = res && node( v.get( ) );
+                    }
+                    break;
+                }
+                case AT::LIST: {
+                    auto l = ast::cast<AEX::list>( n );
+                    uint( nodes, static_cast<std::uint64_t>( l->get_role( ) ) );
+                    uint( nodes, l->value( ).size( ) );
+                    for( auto &v: l->value( ) ) {
+                        res = res && node( v.get( ) );
+                    }
+                    break;
+                }
+                case AT::TABLE: {
+                    auto t = ast::cast<AEX::table>( n );
+                    uint( nodes, t->value( ).size( ) );
+                    for( auto &v: t->value( ) ) {
+                        res = res && node( v.first.get( ) )
+                                  && node( v.second.get( ) );
+                    }
+                    break;
+                }
+                case AT::FN: {
+                    auto f = ast::cast<AEX::function>( n );
+                    uint( nodes, f->inits( ).size( ) );
+                    for( auto &i: f->inits( ) ) {
+                        str( i.first );
+                        res = res && node( i.second.get( ) );
+                    }
+                    res = res && list( f->params( ).get( ) )
+                              && node( f->body( ).get( ) );
+                    break;
+                }
+                case AT::CALL: {
+                    auto c = ast::cast<AEX::call>( n );
+                    res = node( c->func( ).get( ) )
+                       && list( c->params( ).get( ) );
+                    break;
+                }
+                case AT::INDEX: {
+                    auto i = ast::cast<AEX::index>( n );
+                    res = node( i->value( ).get( ) )
+                       && node( i->param( ).get( ) );
+                    break;
+                }
+                case AT::IFELSE: {
+                    auto i = ast::cast<AEX::ifelse>( n );
+                    uint( nodes, i->is_unless( ) ? 1 : 0 );
+                    uint( nodes, i->ifs( ).size( ) );
+                    for( auto &g: i->ifs( ) ) {
+                        res = res && node( g.cond.get( ) )
+                                  && node( g.body.get( ) );
+                    }
+                    res = res && node( i->alt( ).get( ) );
+                    break;
+                }
+                case AT::ELIPSIS:
+                    res = node( ast::cast<AEX::elipsis>( n )->value( ).get( ) );
+                    break;
+                case AT::MODULE: {
+                    auto m = ast::cast<AEX::mod>( n );
+                    res = node( m->name( ).get( ) );
+                    uint( nodes, m->parents( ).size( ) );
+                    for( auto &p: m->parents( ) ) {
+                        res = res && node( p.get( ) );
+                    }
+                    res = res && node( m->body( ).get( ) );
+                    break;
+                }
+                case AT::FORIN: {
+                    auto f = ast::cast<AEX::forin>( n );
+                    res = list( f->idents( ).get( ) )
+                       && list( f->expres( ).get( ) )
+                       && list( f->body( ).get( ) );
+                    break;
+                }
+                case AT::MOD_MUT:
+                    res = node( ast::cast<AEX::mod_mut>( n )->value( ).get( ) );
+                    break;
+                case AT::MOD_CONST:
+                    res = node( ast::cast<AEX::mod_const>( n )
+                                                    ->value( ).get( ) );
+                    break;
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+                case AT::QUOTE:
+                    res = node( ast::cast<AEX::quote>( n )->value( ).get( ) );
+                    break;
+                case AT::UNQUOTE:
+                    res = node( ast::cast<AEX::unquote>( n )
+                                                    ->value( ).get( ) );
+                    break;
+                case AT::MACRO: {
+                    auto m = ast::cast<AEX::macro>( n );
+                    res = list( m->params( ).get( ) )
+                       && node( m->body( ).get( ) );
+                    break;
+                }
+#endif
+                default:
+                    /// registry values and built-in macros live in memory
+                    return fail( n );
+                }
+                return res;
+            }
+
+            std::string nodes;
+            std::string positions;
+            std::vector<const std::string *> strings;
+            std::unordered_map<std::string, std::uint64_t> ids;
+            std::uint64_t count = 0;
+            std::int64_t last_line = 0;
+            std::int64_t last_col  = 0;
+            std::string error;
+        };
+
+        struct reader {
+
+            struct range {
+                const char *cur;
+                const char *end;
+            };
+
+            reader( const char *b, const char *e )
+                :strs{b, e}
+            { }
+
+            std::uint64_t uint( range &r )
+            {
+                std::uint64_t res = 0;
+                for( unsigned shift = 0; shift < 64; shift += 7 ) {
+                    if( r.cur == r.end ) {
+                        break;
+                    }
+                    auto c = static_cast<std::uint8_t>( *r.cur++ );
+                    res |= static_cast<std::uint64_t>( c & 0x7F ) << shift;
+                    if( !(c & 0x80) ) {
+                        return res;
+                    }
+                }
+                ok = false;
+                return 0;
+            }
+
+            static
+            std::int64_t unzigzag( std::uint64_t u )
+            {
+                return static_cast<std::int64_t>( (u & 1) ? ~(u >> 1)
+                                                          : (u >> 1) );
+            }
+
+            std::int64_t sint( range &r )
+            {
+                return unzigzag( uint( r ) );
+            }
+
+            tokens::position position( )
+            {
+                auto val = uint( positions );
+                switch( val & 3 ) {
+                case 0:
+                    return tokens::position( );
+                case 1:
+                    col += unzigzag( val >> 2 );
+                    break;
+                case 2:
+                    line += unzigzag( val >> 2 );
+                    col   = static_cast<std::int64_t>( uint( positions ) );
+                    break;
+                default:
+                    ok = false;
+                    break;
+                }
+                return tokens::position( static_cast<std::size_t>( line ),
+                                         static_cast<std::size_t>( col ) );
+            }
+
+            bool read_strings( )
+            {
+                auto size = uint( strs );
+                for( std::uint64_t i = 0; ok && i < size; ++i ) {
+                    auto len = uint( strs );
+                    if( len > static_cast<std::uint64_t>( strs.end
+                                                        - strs.cur ) ) {
+                        return false;
+                    }
+                    strings.emplace_back( strs.cur, len );
+                    strs.cur += len;
+                }
+                return ok && strs.cur == strs.end;
+            }
+
+            const std::string &str( )
+            {
+                static const std::string empty;
+                auto id = uint( nodes );
+                if( id >= strings.size( ) ) {
+                    ok = false;
+                    return empty;
+                }
+                return strings[id];
+            }
+
+            /// a list; nullptr if the next node is not one
+            ast::expressions::list::uptr list( )
+            {
+                auto n = node( );
+                if( !n || n->get_type( ) != ast::type::LIST ) {
+                    ok = false;
+                    return nullptr;
+                }
+                return ast::cast<ast::expressions::list>( n );
+            }
+
+            ast::expression::uptr expr( )
+            {
+                auto n = node( );
+                if( n && !n->is_expression( ) ) {
+                    ok = false;
+                    return nullptr;
+                }
+                return n ? ast::expression::cast( n ) : nullptr;
+            }
+
+            ast::node::uptr need( )
+            {
+                auto n = node( );
+                if( !n ) {
+                    ok = false;
+                }
+                return n;
+            }
+
+            ast::expression::uptr need_expr( )
+            {
+                auto n = expr( );
+                if( !n ) {
+                    ok = false;
+                }
+                return n;
+            }
+
+            ast::node::uptr node( )
+            {
+                using AT = ast::type;
+                namespace AST = ast::statements;
+                namespace AEX = ast::expressions;
+
+                auto tag = uint( nodes );
+                if( !ok || tag == no_node ) {
+                    return nullptr;
+                }
+
+                if( count == 0 ) {
+                    ok = false;
+                    return nullptr;
+                }
+                --count;
+
+                auto pos = position( );
+
+                ast::node::uptr res;
+
+                switch( static_cast<AT>( tag ) ) {
+                case AT::PROGRAM: {
+                    auto p = ast::node::make<ast::program>( );
+                    auto size = uint( nodes );
+                    for( std::uint64_t i = 0; ok && i < size; ++i ) {
+                        p->states( ).emplace_back( need( ) );
+                    }
+                    res = std::move(p);
+                    break;
+                }
+                case AT::IDENT: {
+                    auto val = str( );
+                    res = ast::node::make<AEX::ident>( val, str( ) );
+                    break;
+                }
+                case AT::LET: {
+                    bool mut = uint( nodes ) != 0;
+                    auto id  = need( );
+                    auto val = need( );
+                    if( !id || !val ) {
+                        ok = false;
+                        break;
+                    }
+                    res.reset( new AST::let( std::move(id), std::move(val),
+                                             mut ) );
+                    break;
+                }
+                case AT::EXPR: {
+                    auto val = expr( );
+                    if( !val ) {
+                        ok = false;
+                        break;
+                    }
+                    res = AST::expr::make( std::move(val) );
+                    break;
+                }
+                case AT::RETURN:
+                    res = AST::ret::make( need( ) );
+                    break;
+                case AT::BREAK:
+                    res = ast::node::make<AST::break_expr>( );
+                    break;
+                case AT::CONTINUE:
+                    res = ast::node::make<AST::cont_expr>( );
+                    break;
+                case AT::NONE:
+                    res = AEX::null::make( );
+                    break;
+                case AT::PREFIX: {
+                    auto tt  = static_cast<tokens::type>( uint( nodes ) );
+                    auto val = need( );
+                    res = ast::node::make<AEX::prefix>( tt, std::move(val) );
+                    break;
+                }
+                case AT::INFIX: {
+                    auto tt  = static_cast<tokens::type>( uint( nodes ) );
+                    auto lft = need( );
+                    auto i   = AEX::infix::make( tt, std::move(lft) );
+                    i->set_right( need( ) );
+                    res = std::move(i);
+                    break;
+                }
+                case AT::STRING: {
+                    bool raw = uint( nodes ) != 0;
+                    res = ast::node::make<AEX::string>( str( ), raw );
+                    break;
+                }
+                case AT::CHARACTER: {
+                    using CT = AEX::character::value_type;
+                    auto val = static_cast<CT>( uint( nodes ) );
+                    res = ast::node::make<AEX::character>( val );
+                    break;
+                }
+                case AT::INTEGER:
+                    res = AEX::integer::make( sint( nodes ) );
+                    break;
+                case AT::BOOLEAN:
+                    res = ast::node::make<AEX::boolean>( uint( nodes ) != 0 );
+                    break;
+                case AT::FLOAT: {
+                    if( nodes.end - nodes.cur < 8 ) {
+                        ok = false;
+                        break;
+                    }
+                    auto bits = get_fixed( nodes.cur, 8 );
+                    nodes.cur += 8;
+                    double val;
+                    std::memcpy( &val, &bits, sizeof(val) );
+                    res = AEX::floating::make( val );
+                    break;
+                }
+                case AT::INFIN:
+                    res = AEX::infinite::make( uint( nodes ) != 0 );
+                    break;
+                case AT::ARRAY: {
+                    auto a = ast::node::make<AEX::array>( );
+                    auto size = uint( nodes );
+                    for( std::uint64_t i = 0; ok && i < size; ++i ) {
+                        a->value( ).emplace_back( need( ) );
+                    }
+                    res = std::move(a);
+                    break;
+                }
+                case AT::LIST: {
+                    using role = AEX::list::role;
+                    auto r = uint( nodes ) == 0 ? role::LIST_SCOPE
+                                                : role::LIST_PARAMS;
+                    auto l = ast::node::make<AEX::list>( r );
+                    auto size = uint( nodes );
+                    for( std::uint64_t i = 0; ok && i < size; ++i ) {
+                        l->value( ).emplace_back( need( ) );
+                    }
+                    res = std::move(l);
+                    break;
+                }
+                case AT::TABLE: {
+                    auto t = ast::node::make<AEX::table>( );
+                    auto size = uint( nodes );
+                    for( std::uint64_t i = 0; ok && i < size; ++i ) {
+                        auto key = need( );
+                        auto val = need( );
+                        t->value( ).emplace_back( std::move(key),
+                                                  std::move(val) );
+                    }
+                    res = std::move(t);
+                    break;
+                }
+                case AT::FN: {
+                    auto f = ast::node::make<AEX::function>( );
+                    auto size = uint( nodes );
+                    for( std::uint64_t i = 0; ok && i < size; ++i ) {
+                        std::string name = str( );
+                        f->inits( ).emplace( std::move(name), need( ) );
+                    }
+                    auto params = list( );
+                    if( params ) {
+                        f->set_params( std::move(params) );
+                    }
+                    f->set_body( node( ) );
+                    res = std::move(f);
+                    break;
+                }
+                case AT::CALL: {
+                    auto c = ast::node::make<AEX::call>( need( ) );
+                    auto params = list( );
+                    if( params ) {
+                        c->set_params( std::move(params) );
+                    }
+                    res = std::move(c);
+                    break;
+                }
+                case AT::INDEX: {
+                    auto lft = need( );
+                    auto prm = need( );
+                    res = ast::node::make<AEX::index>( std::move(lft),
+                                                       std::move(prm) );
+                    break;
+                }
+                case AT::IFELSE: {
+                    auto i = AEX::ifelse::make( uint( nodes ) != 0 );
+                    auto size = uint( nodes );
+                    for( std::uint64_t g = 0; ok && g < size; ++g ) {
+                        AEX::ifelse::node next;
+                        next.cond = need_expr( );
+                        next.body = need_expr( );
+                        i->ifs( ).emplace_back( std::move(next) );
+                    }
+                    i->alt( ) = expr( );
+                    res = std::move(i);
+                    break;
+                }
+                case AT::ELIPSIS:
+                    res = AEX::elipsis::make( need( ) );
+                    break;
+                case AT::MODULE: {
+                    auto name    = need( );
+                    auto parents = AEX::list::make_params( );
+                    auto size    = uint( nodes );
+                    for( std::uint64_t i = 0; ok && i < size; ++i ) {
+                        parents->value( ).emplace_back( need( ) );
+                    }
+                    auto m = ast::node::make<AEX::mod>( std::move(name),
+                                                        std::move(parents) );
+                    m->set_body( need( ) );
+                    res = std::move(m);
+                    break;
+                }
+                case AT::FORIN: {
+                    auto f = AEX::forin::make( );
+                    f->set_idents( list( ) );
+                    f->set_expres( list( ) );
+                    f->set_body( list( ) );
+                    res = std::move(f);
+                    break;
+                }
+                case AT::MOD_MUT:
+                    res = AEX::mod_mut::make( need( ) );
+                    break;
+                case AT::MOD_CONST:
+                    res = AEX::mod_const::make( need( ) );
+                    break;
+#if !defined(DISABLE_MACRO) || !DISABLE_MACRO
+                case AT::QUOTE:
+                    res = AEX::quote::make( need( ) );
+                    break;
+                case AT::UNQUOTE:
+                    res = AEX::unquote::make( need( ) );
+                    break;
+                case AT::MACRO: {
+                    auto m = ast::node::make<AEX::macro>( );
+                    auto params = list( );
+                    if( params ) {
+                        m->set_params( std::move(params) );
+                    }
+                    m->set_body( need( ) );
+                    res = std::move(m);
+                    break;
+                }
+#endif
+                default:
+                    ok = false;
+                    break;
+                }
+
+                if( !ok || !res ) {
+                    ok = false;
+                    return nullptr;
+                }
+                res->set_pos( pos );
+                return res;
+            }
+
+            range strs;
+            range nodes { nullptr, nullptr };
+            range positions { nullptr, nullptr };
+            std::vector<std::string> strings;
+            std::uint64_t count = 0;
+            std::int64_t line = 0;
+            std::int64_t col  = 0;
+            bool ok = true;
+        };
+    };
+
+}
+
+#endif // MICO_MICOC_H
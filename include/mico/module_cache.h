@@ -0,0 +1,221 @@
+#ifndef MICO_MODULE_CACHE_H
+#define MICO_MODULE_CACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define MICO_MODULE_STAT 1
+#   include <sys/stat.h>
+#   include <limits.h>
+#endif
+
+#include "mico/ast.h"
+
+namespace mico {
+
+    /// Programs of exported files.
+    /// A file is parsed once for the whole process; every 'export' of it
+    /// gets a copy of the same tree. Files are known by their canonical
+    /// path, a changed time or size makes the file new again. The time
+    /// has nanoseconds, two writes in one second are two versions.
+    class module_cache {
+
+    public:
+
+        struct stamp {
+            std::string    path;
+            /// nanoseconds since the epoch
+            std::int64_t   mtime = 0;
+            std::uint64_t  size  = 0;
+
+            bool operator == ( const stamp &other ) const
+            {
+                return mtime == other.mtime && size == other.size
+                    && path == other.path;
+            }
+        };
+
+        enum class status {
+            MISS     = 0,
+            HIT      = 1,
+            /// the file is being parsed; it exports itself
+            CYCLE    = 2,
+        };
+
+        static
+        module_cache &instance( )
+        {
+            static module_cache res;
+            return res;
+        }
+
+        /// the file that 'export' means: the name itself or the name
+        /// with '.mico'
+        static
+        std::string resolve( std::string path )
+        {
+            std::ifstream f(path, std::ifstream::binary);
+            if( !f.is_open( ) ) {
+                path += ".mico";
+            }
+            return path;
+        }
+
+        /// false if the file can not be found
+        static
+        bool make_stamp( const std::string &path, stamp &res )
+        {
+#if defined(MICO_MODULE_STAT)
+            struct stat st;
+            if( ::stat( path.c_str( ), &st ) != 0 ) {
+                return false;
+            }
+            char full[PATH_MAX];
+            if( ::realpath( path.c_str( ), full ) ) {
+                res.path = full;
+            } else {
+                res.path = path;
+            }
+            res.mtime = mtime_ns( st );
+            res.size  = static_cast<std::uint64_t>( st.st_size );
+            return true;
+#else
+            std::ifstream f(path, std::ifstream::binary);
+            if( !f.is_open( ) ) {
+                return false;
+            }
+            f.seekg( 0, f.end );
+            res.path  = path;
+            res.mtime = 0;
+            res.size  = static_cast<std::uint64_t>( f.tellg( ) );
+            return true;
+#endif
+        }
+
+#if defined(MICO_MODULE_STAT)
+        static
+        std::int64_t mtime_ns( const struct stat &st )
+        {
+#   if defined(__APPLE__)
+            const auto &ts( st.st_mtimespec );
+#   else
+            const auto &ts( st.st_mtim );
+#   endif
+            return static_cast<std::int64_t>( ts.tv_sec ) * 1000000000
+                 + static_cast<std::int64_t>( ts.tv_nsec );
+        }
+#endif
+
+        /// a copy of the cached program on HIT; on MISS the caller parses
+        /// the file and calls 'put'
+        status get( const stamp &key, ast::program::uptr &res )
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            auto f = entries_.find( key.path );
+            if( f != entries_.end( ) && f->second.key == key ) {
+                if( !f->second.prog ) {
+                    return status::CYCLE;
+                }
+                auto copy = f->second.prog->clone( );
+                res = ast::cast<ast::program>( copy );
+                /// the first 'export' of a file that was parsed ahead
+                /// is not a reuse
+                hits_ += f->second.ahead ? 0 : 1;
+                f->second.ahead = false;
+                return status::HIT;
+            }
+            auto &e( entries_[key.path] );
+            e.key   = key;
+            e.prog.reset( );
+            e.ahead = false;
+            ++misses_;
+            return status::MISS;
+        }
+
+        /// 'compiled' if the program was read from a .micoc file
+        void put( const stamp &key, const ast::program &prog,
+                  bool compiled = false )
+        {
+            auto copy = prog.clone( );
+            std::lock_guard<std::mutex> lck(lock_);
+            compiled_ += compiled ? 1 : 0;
+            auto &e( entries_[key.path] );
+            e.key   = key;
+            e.prog  = ast::cast<ast::program>( copy );
+            e.ahead = false;
+        }
+
+        /// the program is made before the first 'export' of the file
+        /// asks for it; the cache takes it as it is
+        void keep( const stamp &key, ast::program::uptr prog,
+                   bool compiled = false )
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            compiled_ += compiled ? 1 : 0;
+            auto &e( entries_[key.path] );
+            e.key   = key;
+            e.prog  = std::move(prog);
+            e.ahead = true;
+        }
+
+        /// the file is parsed or being parsed
+        bool contains( const stamp &key ) const
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            auto f = entries_.find( key.path );
+            return f != entries_.end( ) && f->second.key == key;
+        }
+
+        /// the file could not be parsed; the next 'export' tries again.
+        /// A failed parse 'ahead' is not counted, the parser repeats it
+        void drop( const stamp &key, bool ahead = false )
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            if( entries_.erase( key.path ) && ahead ) {
+                --misses_;
+            }
+        }
+
+        std::size_t hits( ) const
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            return hits_;
+        }
+
+        std::size_t misses( ) const
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            return misses_;
+        }
+
+        std::size_t compiled( ) const
+        {
+            std::lock_guard<std::mutex> lck(lock_);
+            return compiled_;
+        }
+
+    private:
+
+        struct entry {
+            stamp               key;
+            ast::program::uptr  prog;
+            bool                ahead = false;
+        };
+
+        module_cache( ) = default;
+
+        mutable std::mutex            lock_;
+        std::map<std::string, entry>  entries_;
+        std::size_t                   hits_     = 0;
+        std::size_t                   misses_   = 0;
+        std::size_t                   compiled_ = 0;
+    };
+
+}
+
+#endif // MICO_MODULE_CACHE_H
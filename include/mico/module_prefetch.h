@@ -0,0 +1,203 @@
+#ifndef MICO_MODULE_PREFETCH_H
+#define MICO_MODULE_PREFETCH_H
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include "mico/lexer.h"
+#include "mico/source.h"
+#include "mico/module_cache.h"
+#include "mico/micoc.h"
+
+namespace mico {
+
+    /// Exported files of a program parsed ahead on several threads.
+    /// The lexer alone finds the 'export's of every file, so all the
+    /// files are known before anything is parsed. A file is parsed when
+    /// all the files it exports are in the cache: its own 'export's are
+    /// hits and the threads never wait for each other. The parser then
+    /// puts the trees into the program in its usual order. Files that
+    /// fail here (errors, cycles) are left to the parser; it reports
+    /// them the same way as if nothing was parsed ahead.
+    class module_prefetch {
+
+        struct file {
+            std::string               path;
+            std::size_t               pending = 0;
+            std::vector<std::size_t>  users;
+        };
+
+    public:
+
+        /// parses 'path' into the cache; false if it failed
+        using load_call = std::function<bool (const std::string &)>;
+
+        /// paths of the 'export's in 'src' as they are written
+        static
+        std::vector<std::string> exports( const source::sptr &src )
+        {
+            std::vector<std::string> res;
+            static const char word[ ] = "export";
+            auto b = src->begin( );
+            auto e = src->end( );
+            /// most files export nothing; they are not lexed here
+            if( std::search( b, e, word, word + sizeof(word) - 1 ) == e ) {
+                return res;
+            }
+
+            using TT = tokens::type;
+            lexer::stream tokens( src );
+            bool after = false;
+            for( auto t = tokens.next( ); t.ident.name != TT::END_OF_FILE;
+                      t = tokens.next( ) ) {
+                if( after && ( t.ident.name == TT::IDENT ||
+                               t.ident.name == TT::STRING ) ) {
+                    res.emplace_back( t.ident.value( ) );
+                }
+                after = ( t.ident.name == TT::EXPORT );
+            }
+            return res;
+        }
+
+        /// 'threads' is the number of threads including the caller;
+        /// 0 is one per core. One thread does nothing, the parser is
+        /// as fast alone
+        static
+        void run( const source::sptr &src, load_call load,
+                  std::size_t threads = 0 )
+        {
+            if( threads == 0 ) {
+                threads = std::thread::hardware_concurrency( );
+            }
+
+            std::vector<file> files;
+            if( threads < 2 || !find( src, files ) ) {
+                return;
+            }
+            threads = std::min( threads, files.size( ) );
+
+            std::mutex                lock;
+            std::condition_variable   cond;
+            std::deque<std::size_t>   ready;
+            std::size_t               running = 0;
+
+            for( std::size_t i = 0; i < files.size( ); ++i ) {
+                if( files[i].pending == 0 ) {
+                    ready.push_back( i );
+                }
+            }
+
+            auto worker = [&]( ) {
+                std::unique_lock<std::mutex> lck(lock);
+                while( true ) {
+                    cond.wait( lck, [&]( ) {
+                        return !ready.empty( ) || running == 0;
+                    } );
+                    if( ready.empty( ) ) {
+                        return;
+                    }
+                    auto id = ready.front( );
+                    ready.pop_front( );
+                    ++running;
+
+                    lck.unlock( );
+                    bool ok = load( files[id].path );
+                    lck.lock( );
+
+                    --running;
+                    /// a file that failed holds everything that uses it
+                    if( ok ) {
+                        for( auto u: files[id].users ) {
+                            if( --files[u].pending == 0 ) {
+                                ready.push_back( u );
+                            }
+                        }
+                    }
+                    cond.notify_all( );
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for( std::size_t i = 1; i < threads; ++i ) {
+                pool.emplace_back( worker );
+            }
+            worker( );
+            for( auto &t: pool ) {
+                t.join( );
+            }
+        }
+
+    private:
+
+        /// every file that is exported from 'src' directly or not;
+        /// false if there are less than two, one file is parsed in
+        /// place as fast as here
+        static
+        bool find( const source::sptr &src, std::vector<file> &files )
+        {
+            const auto npos = std::string::npos;
+            auto &cache( module_cache::instance( ) );
+            std::map<std::string, std::size_t> known;
+            std::vector<std::vector<std::string> > uses;
+
+            uses.emplace_back( exports( src ) );
+            std::vector<std::size_t> owners( 1, npos );
+
+            for( std::size_t next = 0; next < uses.size( ); ++next ) {
+                for( auto &name: uses[next] ) {
+                    auto path = module_cache::resolve( name );
+                    module_cache::stamp key;
+                    if( !module_cache::make_stamp( path, key )
+                      || cache.contains( key ) ) {
+                        continue;
+                    }
+                    auto f = known.find( key.path );
+                    std::size_t id = 0;
+                    if( f == known.end( ) ) {
+                        id = files.size( );
+                        known[key.path] = id;
+                        files.emplace_back( );
+                        files.back( ).path = path;
+                        uses.emplace_back( file_exports( path, key ) );
+                        owners.push_back( id );
+                    } else {
+                        id = f->second;
+                    }
+                    auto owner = owners[next];
+                    if( owner != npos ) {
+                        files[id].users.push_back( owner );
+                        ++files[owner].pending;
+                    }
+                }
+            }
+            return files.size( ) > 1;
+        }
+
+        /// nothing for a file that has a fresh .micoc; it is whole
+        static
+        std::vector<std::string> file_exports( const std::string &path,
+                                               const module_cache::stamp &key )
+        {
+            auto compiled = source::load( micoc::path_for( path ) );
+            if( compiled && micoc::fresh( (*compiled)->begin( ),
+                                          (*compiled)->end( ), key ) ) {
+                return std::vector<std::string>( );
+            }
+            auto data = source::load( path );
+            if( !data ) {
+                return std::vector<std::string>( );
+            }
+            return exports( *data );
+        }
+    };
+
+}
+
+#endif // MICO_MODULE_PREFETCH_H
@@ -9,6 +9,7 @@
 
 #include "mico/charset/encoding.h"
 #include "mico/environment.h"
+#include "mico/state.h"
 
 namespace mico { namespace modules {
 
@@ -23,7 +24,7 @@ namespace mico { namespace modules {
             {
                 if( pp.empty( ) ) {
                     if( auto p = root.lock( ) ) {
-                        p->get_state( ).GC( p );
+                        p->get_state( ).collect( p );
                     }
                     return objects::integer::make( 0 );
                 } else {
@@ -32,19 +33,19 @@ namespace mico { namespace modules {
                         switch ( o->get_type( ) ) {
                         case objects::type::FUNCTION: {
                             auto fun = objects::cast_func( o.get( ) );
-                            fun->env( )->get_state( ).GC( fun->env( ) );
+                            fun->env( )->get_state( ).collect( fun->env( ) );
                             ++count;
                         }
                             break;
                         case objects::type::BUILTIN: {
                             auto fun = objects::cast_builtin( o.get( ) );
-                            fun->env( )->get_state( ).GC( fun->env( ) );
+                            fun->env( )->get_state( ).collect( fun->env( ) );
                             ++count;
                         }
                             break;
                         case objects::type::MODULE: {
                             auto fun = objects::cast_mod( o.get( ) );
-                            fun->env( )->get_state( ).GC( fun->env( ) );
+                            fun->env( )->get_state( ).collect( fun->env( ) );
                             ++count;
                         }
                             break;
@@ -57,6 +58,100 @@ namespace mico { namespace modules {
             environment::wptr root;
         };
 
+        /// gets the knob; sets it if an integer is passed
+        struct knob {
+
+            using field = std::size_t state::gc_config::*;
+
+            knob( environment::sptr env, field fld )
+                :root(env)
+                ,fld(fld)
+            { }
+
+            objects::sptr operator ( )( objects::slist &pp, environment::sptr )
+            {
+                auto p = root.lock( );
+                if( !p ) {
+                    return objects::null::make( );
+                }
+                auto &conf( p->get_state( ).gc_conf( ) );
+                auto old = static_cast<std::int64_t>( conf.*fld );
+                if( !pp.empty( ) ) {
+                    if( pp[0]->get_type( ) != objects::type::INTEGER ) {
+                        return objects::error::make( pp[0]->get_type( ),
+                                                     " is not an integer" );
+                    }
+                    auto val = objects::cast_int( pp[0].get( ) )->value( );
+                    if( val < 1 ) {
+                        return objects::error::make( "Bad value ", val );
+                    }
+                    conf.*fld = static_cast<std::size_t>( val );
+                }
+                return objects::integer::make( old );
+            }
+
+            environment::wptr root;
+            field             fld;
+        };
+
+        /// runs the cycle collector; returns the bytes it reclaimed
+        struct cycles {
+
+            cycles( environment::sptr env )
+                :root(env)
+            { }
+
+            objects::sptr operator ( )( objects::slist &, environment::sptr )
+            {
+                std::int64_t res = 0;
+                if( auto p = root.lock( ) ) {
+                    auto stat = p->get_state( ).collect_cycles( p );
+                    res = static_cast<std::int64_t>( stat.bytes );
+                }
+                return objects::integer::make( res );
+            }
+
+            environment::wptr root;
+        };
+
+        /// bytes reclaimed by the last cycle collection
+        struct reclaimed {
+
+            reclaimed( environment::sptr env )
+                :root(env)
+            { }
+
+            objects::sptr operator ( )( objects::slist &, environment::sptr )
+            {
+                std::int64_t res = 0;
+                if( auto p = root.lock( ) ) {
+                    auto &stat( p->get_state( ).last_cycle( ) );
+                    res = static_cast<std::int64_t>( stat.bytes );
+                }
+                return objects::integer::make( res );
+            }
+
+            environment::wptr root;
+        };
+
+        struct young {
+
+            young( environment::sptr env )
+                :root(env)
+            { }
+
+            objects::sptr operator ( )( objects::slist &, environment::sptr )
+            {
+                std::int64_t res = 0;
+                if( auto p = root.lock( ) ) {
+                    res = static_cast<std::int64_t>( p->young_size( ) );
+                }
+                return objects::integer::make( res );
+            }
+
+            environment::wptr root;
+        };
+
         static
         void load( environment::sptr &env, const std::string &name = "gc" )
         {
@@ -64,6 +159,15 @@ namespace mico { namespace modules {
             auto mod_env = environment::make(env);
             auto mod = objects::module::make( mod_env, name );
             mod_env->set_const( "collect", BC::make( mod_env, collect(env) ) );
+            using CONF = state::gc_config;
+            mod_env->set_const( "threshold",
+                    BC::make( mod_env, knob( env, &CONF::threshold ) ) );
+            mod_env->set_const( "major",
+                    BC::make( mod_env, knob( env, &CONF::major_every ) ) );
+            mod_env->set_const( "young", BC::make( mod_env, young(env) ) );
+            mod_env->set_const( "cycles", BC::make( mod_env, cycles(env) ) );
+            mod_env->set_const( "reclaimed",
+                                BC::make( mod_env, reclaimed(env) ) );
             env->set_const( name, mod );
         }
     };
@@ -0,0 +1,250 @@
+#ifndef MICO_NODE_POOL_H
+#define MICO_NODE_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace mico { namespace ast {
+
+    /// Memory for AST nodes.
+    /// A parser makes many small nodes and a program drops them all at
+    /// once; nodes come from free lists of a few size classes that grow
+    /// by blocks. Every thread has its own lists, a node can be freed
+    /// on any thread. Blocks are never given back to the system: nodes
+    /// can outlive the thread and the program that made them (function
+    /// bodies are shared with closures). A thread that ends, or holds
+    /// too many free nodes, leaves them to the threads that need a new
+    /// block; the threads that read exported files and the thread that
+    /// frees their trees do not add blocks for every file.
+    /// Trees can be freed after the lists of their thread are gone
+    /// (static objects of the main thread such as the module cache), so
+    /// the shared lists are never destroyed and such nodes go there.
+    class node_pool {
+
+        static const std::size_t granularity = 16;
+        static const std::size_t classes     = 16;
+        static const std::size_t block_size  = 64 * 1024;
+        static const std::size_t spare_limit = 4 * block_size;
+
+        struct free_node {
+            free_node *next;
+        };
+
+        /// the unused end of a block
+        struct rest_node {
+            rest_node   *next;
+            std::size_t  size;
+        };
+
+        using heads_type = std::array<free_node *, classes>;
+
+        struct lists {
+            heads_type   heads { };
+            char        *current = nullptr;
+            std::size_t  left    = 0;
+            std::size_t  spare   = 0; /// bytes in 'heads'
+            ~lists( )
+            {
+                give( *this, true );
+                ended( ) = true;
+            }
+        };
+
+        struct shared_lists {
+            std::mutex   lock;
+            heads_type   heads { };
+            rest_node   *rests = nullptr;
+        };
+
+        static
+        lists &local( )
+        {
+            thread_local static lists res;
+            return res;
+        }
+
+        /// set when 'local' is destroyed; has no destructor of its own
+        static
+        bool &ended( )
+        {
+            thread_local static bool res = false;
+            return res;
+        }
+
+        static
+        shared_lists &shared( )
+        {
+            static auto *res = new shared_lists;
+            return *res;
+        }
+
+        static
+        std::size_t class_of( std::size_t size )
+        {
+            return ( size + granularity - 1 ) / granularity - 1;
+        }
+
+        static
+        void push( free_node *&head, void *ptr )
+        {
+            auto node = static_cast<free_node *>(ptr);
+            node->next = head;
+            head = node;
+        }
+
+        static
+        void *pop( lists &l, std::size_t id )
+        {
+            auto head = l.heads[id];
+            if( head ) {
+                l.heads[id] = head->next;
+                l.spare    -= ( id + 1 ) * granularity;
+            }
+            return head;
+        }
+
+        /// puts list 'from' in front of 'to'; returns its length
+        static
+        std::size_t splice( free_node *&to, free_node *&from )
+        {
+            if( !from ) {
+                return 0;
+            }
+            std::size_t res = 1;
+            auto tail = from;
+            for( ; tail->next; ++res ) {
+                tail = tail->next;
+            }
+            tail->next = to;
+            to   = from;
+            from = nullptr;
+            return res;
+        }
+
+        /// the free nodes and, at the end of the thread, its block
+        static
+        void give( lists &l, bool block )
+        {
+            auto &sh( shared( ) );
+            std::lock_guard<std::mutex> lck( sh.lock );
+            for( std::size_t id = 0; id < classes; ++id ) {
+                splice( sh.heads[id], l.heads[id] );
+            }
+            l.spare = 0;
+            if( block && l.left >= sizeof(rest_node) ) {
+                auto rest = reinterpret_cast<rest_node *>(l.current);
+                rest->next = sh.rests;
+                rest->size = l.left;
+                sh.rests   = rest;
+                l.current  = nullptr;
+                l.left     = 0;
+            }
+        }
+
+        /// what the others gave; a node of class 'id' or nullptr
+        static
+        void *take( lists &l, std::size_t id )
+        {
+            auto &sh( shared( ) );
+            std::lock_guard<std::mutex> lck( sh.lock );
+            for( std::size_t i = 0; i < classes; ++i ) {
+                auto count = splice( l.heads[i], sh.heads[i] );
+                l.spare += count * ( i + 1 ) * granularity;
+            }
+            if( auto res = pop( l, id ) ) {
+                return res;
+            }
+            auto full = ( id + 1 ) * granularity;
+            for( auto rest = &sh.rests; *rest; rest = &(*rest)->next ) {
+                if( (*rest)->size >= full ) {
+                    l.current = reinterpret_cast<char *>(*rest);
+                    l.left    = (*rest)->size;
+                    *rest     = (*rest)->next;
+                    break;
+                }
+            }
+            return nullptr;
+        }
+
+        /// the lists of the thread are gone
+        static
+        void *alloc_shared( std::size_t id )
+        {
+            auto &sh( shared( ) );
+            std::lock_guard<std::mutex> lck( sh.lock );
+            if( auto head = sh.heads[id] ) {
+                sh.heads[id] = head->next;
+                return head;
+            }
+            return ::operator new( ( id + 1 ) * granularity );
+        }
+
+        static
+        void free_shared( void *ptr, std::size_t id )
+        {
+            auto &sh( shared( ) );
+            std::lock_guard<std::mutex> lck( sh.lock );
+            push( sh.heads[id], ptr );
+        }
+
+    public:
+
+        static
+        void *alloc( std::size_t size )
+        {
+            auto id = class_of( size );
+            if( id >= classes ) {
+                return ::operator new( size );
+            }
+            if( ended( ) ) {
+                return alloc_shared( id );
+            }
+            auto &l( local( ) );
+            if( auto res = pop( l, id ) ) {
+                return res;
+            }
+            auto full = ( id + 1 ) * granularity;
+            if( l.left < full ) {
+                if( auto res = take( l, id ) ) {
+                    return res;
+                }
+            }
+            if( l.left < full ) {
+                l.current = static_cast<char *>(::operator new( block_size ));
+                l.left    = block_size;
+            }
+            auto res = l.current;
+            l.current += full;
+            l.left    -= full;
+            return res;
+        }
+
+        static
+        void free( void *ptr, std::size_t size )
+        {
+            if( !ptr ) {
+                return;
+            }
+            auto id = class_of( size );
+            if( id >= classes ) {
+                ::operator delete( ptr );
+                return;
+            }
+            if( ended( ) ) {
+                free_shared( ptr, id );
+                return;
+            }
+            auto &l( local( ) );
+            push( l.heads[id], ptr );
+            l.spare += ( id + 1 ) * granularity;
+            if( l.spare > spare_limit ) {
+                give( l, false );
+            }
+        }
+    };
+
+}}
+
+#endif // MICO_NODE_POOL_H
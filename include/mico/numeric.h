@@ -134,8 +134,9 @@ namespace mico {
             return 0;
         }
 
+        template <typename ContT>
         static
-        std::uint64_t parse_int( const std::string &input, tokens::type tt,
+        std::uint64_t parse_int( const ContT &input, tokens::type tt,
                                  int *first_inval )
         {
             std::uint64_t res = 0;
@@ -37,7 +37,8 @@ namespace mico { namespace objects {
         return objects::cast<TypeName>(val);                        \
     }                                                               \
     inline                                                          \
-    std::shared_ptr<impl<TypeName> > cast_##CallPrefix( sptr val )  \
+    mico::shared_ptr<impl<TypeName> >                                \
+    cast_##CallPrefix( const sptr &val )                            \
     {                                                               \
         return objects::cast<TypeName>( val );                      \
     }
@@ -17,9 +17,9 @@ namespace mico { namespace objects {
 
         static const type type_value = type::ARRAY;
 
-        using sptr       = std::shared_ptr<this_type>;
+        using sptr       = mico::shared_ptr<this_type>;
         using cont       = impl<type::REFERENCE>;
-        using cont_sptr  = std::shared_ptr<cont>;
+        using cont_sptr  = mico::shared_ptr<cont>;
         using value_type = std::deque<cont_sptr>;
 
         using slice_type = impl<type::ASLICE>;
@@ -99,7 +99,7 @@ namespace mico { namespace objects {
         static
         sptr make( environment::sptr env )
         {
-            return std::make_shared<this_type>( env );
+            return mico::make_shared<this_type>( env );
         }
 
         hash_type hash( ) const override
@@ -157,6 +157,13 @@ namespace mico { namespace objects {
             }
         }
 
+        void trace( std::vector<const base *> &res ) const override
+        {
+            for( auto &v: value_ ) {
+                res.push_back( v->value( ).get( ) );
+            }
+        }
+
     private:
         value_type  value_;
     };
@@ -8,6 +8,7 @@
 
 #include "mico/ast.h"
 #include "mico/types.h"
+#include "mico/shared.h"
 
 #if defined(DISABLE_SWITCH_WARNINGS)
 #ifdef __clang__
@@ -96,12 +97,22 @@ namespace mico { namespace objects {
             MUTABLE = 0x001,
         };
 
+        /// the type lives in the header; get_type is not a virtual call
+        explicit
+        base( type tn )
+            :type_(tn)
+        { }
+
         virtual ~base( ) = default;
-        virtual type get_type( ) const = 0;
         virtual std::string str( ) const = 0;
-        virtual std::shared_ptr<base> clone( ) const = 0;
+        virtual mico::shared_ptr<base> clone( ) const = 0;
         virtual ast::node::uptr to_ast( tokens::position ) const = 0;
 
+        type get_type( ) const
+        {
+            return type_;
+        }
+
         void set_flags( flags vals )
         {
             mut_ |= static_cast<std::uint32_t>(vals);
@@ -205,23 +216,29 @@ namespace mico { namespace objects {
         {
             return 0;
         }
+
+        /// objects that this one keeps alive; the cycle collector
+        /// follows them. Environments are reported by 'hold'
+        virtual
+        void trace( std::vector<const base *> & ) const
+        { }
     private:
+        const type    type_;
         std::uint32_t mut_ = 0;
     };
 
     template <type TN>
     struct typed_base: public base {
-        type get_type( ) const
-        {
-            return TN;
-        }
+        typed_base( )
+            :base(TN)
+        { }
     };
 
     template <type>
     class impl;
 
-    using sptr  = std::shared_ptr<base>;
-    using wptr  = std::weak_ptr<base>;
+    using sptr  = mico::shared_ptr<base>;
+    using wptr  = mico::weak_ptr<base>;
     using uptr  = std::unique_ptr<base>;
     using slist = std::vector<sptr>;
     using ulist = std::vector<uptr>;
@@ -252,14 +269,14 @@ namespace mico { namespace objects {
 
     template <type ToT>
     inline
-    std::shared_ptr<impl<ToT> > cast( sptr &val )
+    mico::shared_ptr<impl<ToT> > cast( const sptr &val )
     {
 #if defined(CHECK_CASTS)
         if( ToT != val->get_type( ) ) {
             throw  std::runtime_error( "Bad shared<object> cast" );
         }
 #endif
-        return std::shared_ptr<impl<ToT> >(val, cast<ToT>(val.get( ) ) );
+        return mico::shared_ptr<impl<ToT> >(val, cast<ToT>(val.get( ) ) );
     }
 
     inline
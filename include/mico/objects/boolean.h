@@ -16,7 +16,7 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = type::BOOLEAN;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
         using value_type = bool;
 
         explicit
@@ -40,8 +40,8 @@ namespace mico { namespace objects {
         sptr make( bool val )
         {
             key k;
-            static auto true_this  = std::make_shared<this_type>( true, k );
-            static auto false_this = std::make_shared<this_type>( false, k );
+            static auto true_this  = mico::make_shared<this_type>( true, k );
+            static auto false_this = mico::make_shared<this_type>( false, k );
             return val ? true_this : false_this;
         }
 
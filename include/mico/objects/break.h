@@ -12,7 +12,7 @@ namespace mico { namespace objects {
 
         static const type type_value = type::BREAK_OBJ;
 
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         std::string str( ) const override
         {
@@ -22,7 +22,7 @@ namespace mico { namespace objects {
         static
         sptr make( )
         {
-            static auto val = std::make_shared<this_type>( );
+            static auto val = mico::make_shared<this_type>( );
             return val;
         }
 
@@ -22,7 +22,7 @@ namespace mico { namespace objects {
 
         static const type type_value = type::STRING;
 
-        using sptr        = std::shared_ptr<this_type>;
+        using sptr        = mico::shared_ptr<this_type>;
         using value_type  = internal_type::value_type;
 
         std::string str( ) const override
@@ -62,10 +62,15 @@ namespace mico { namespace objects {
             return h(value( ));
         }
 
+        /// ASCII characters are shared
         static
         sptr make( value_type val )
         {
-            return std::make_shared<this_type>( val );
+            if( static_cast<std::uint32_t>(val) < ascii_size ) {
+                static const std::vector<sptr> cache = make_cache( );
+                return cache[static_cast<std::size_t>(val)];
+            }
+            return mico::make_shared<this_type>( val );
         }
 
         bool equal( const base *other ) const override
@@ -79,7 +84,7 @@ namespace mico { namespace objects {
 
         objects::sptr clone( ) const override
         {
-            return std::make_shared<this_type>( value_ );
+            return make( value_ );
         }
 
         ast::node::uptr to_ast( tokens::position pos ) const override
@@ -90,6 +95,20 @@ namespace mico { namespace objects {
 
     private:
 
+        static const std::uint32_t ascii_size = 128;
+
+        static
+        std::vector<sptr> make_cache( )
+        {
+            std::vector<sptr> res;
+            res.reserve( ascii_size );
+            for( std::uint32_t i = 0; i < ascii_size; ++i ) {
+                res.emplace_back( mico::make_shared<this_type>(
+                                  static_cast<value_type>(i) ) );
+            }
+            return res;
+        }
+
         value_type value_;
 
     };
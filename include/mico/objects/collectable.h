@@ -58,7 +58,7 @@ namespace mico { namespace objects {
 
     private:
 
-        std::weak_ptr<environment>  env_;
+        mico::weak_ptr<environment>  env_;
     };
 
 }}
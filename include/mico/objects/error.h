@@ -17,7 +17,7 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = type::FAILURE;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         using value_type = std::string;
 
@@ -78,7 +78,7 @@ namespace mico { namespace objects {
         {
             std::ostringstream oss;
             out_err( oss, std::forward<Args>(args)...);
-            return std::make_shared<this_type>( where, oss.str( ) );
+            return mico::make_shared<this_type>( where, oss.str( ) );
         }
 
         template <typename ...Args>
@@ -27,7 +27,7 @@ namespace mico { namespace objects {
 
     public:
         static const type type_value = type::FUNCTION;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         using param_iterator = ast::node_list::iterator;
 
@@ -80,7 +80,16 @@ namespace mico { namespace objects {
         sptr make( environment::sptr e, param_type::uptr par,
                    ast::node::uptr body, std::size_t start = 0 )
         {
-            return std::make_shared<impl>( e, std::move(par),
+            return mico::make_shared<impl>( e, std::move(par),
+                                           std::move(body), start );
+        }
+
+        /// the literal and every closure made from it share the AST
+        static
+        sptr make( environment::sptr e, param_ptr par,
+                   body_ptr body, std::size_t start = 0 )
+        {
+            return mico::make_shared<impl>( e, std::move(par),
                                            std::move(body), start );
         }
 
@@ -88,7 +97,7 @@ namespace mico { namespace objects {
         sptr make( environment::sptr e,
                    this_type &other, std::size_t start )
         {
-            return std::make_shared<impl>( e, other.params_, other.body_,
+            return mico::make_shared<impl>( e, other.params_, other.body_,
                                            start + other.start_param_ );
         }
 
@@ -98,7 +107,7 @@ namespace mico { namespace objects {
             if( other->start_param_ != 0 ) {
                 if( auto p = other->env( ) ) {
                     //auto np = environment::make( p->parent( ) );
-                    return std::make_shared<impl>( p->parent( ),
+                    return mico::make_shared<impl>( p->parent( ),
                                                    other->params_,
                                                    other->body_, 0 );
                 }
@@ -141,9 +150,14 @@ namespace mico { namespace objects {
             return body_.get( );
         }
 
+        const body_ptr &shared_body( ) const
+        {
+            return body_;
+        }
+
         objects::sptr clone( ) const override
         {
-            return std::make_shared<this_type>( env( ), params_, body_,
+            return mico::make_shared<this_type>( env( ), params_, body_,
                                                 start_param_ );
         }
 
@@ -194,7 +208,7 @@ namespace mico { namespace objects {
     public:
         static const type type_value = type::BUILTIN;
 
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         impl( environment::sptr &e )
             :collectable(e)
@@ -249,7 +263,7 @@ namespace mico { namespace objects {
         using this_type = impl<type::TAIL_CALL>;
     public:
         static const type type_value = type::TAIL_CALL;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         impl(objects::sptr obj, objects::slist p, environment::sptr e)
             :collectable(e)
@@ -287,13 +301,13 @@ namespace mico { namespace objects {
         static
         sptr make( objects::sptr obj, objects::slist p, environment::sptr e )
         {
-            return std::make_shared<this_type>( obj, std::move(p), e );
+            return mico::make_shared<this_type>( obj, std::move(p), e );
         }
 
         static
         sptr make( objects::sptr obj, environment::sptr e )
         {
-            return std::make_shared<this_type>( obj, objects::slist { }, e );
+            return mico::make_shared<this_type>( obj, objects::slist { }, e );
         }
 
         objects::slist &params( )
@@ -301,9 +315,9 @@ namespace mico { namespace objects {
             return params_;
         }
 
-        std::shared_ptr<base> clone( ) const override
+        mico::shared_ptr<base> clone( ) const override
         {
-            return std::make_shared<this_type>( obj_, params_, env( ) );
+            return mico::make_shared<this_type>( obj_, params_, env( ) );
         }
 
         ast::node::uptr to_ast( tokens::position /*pos*/ ) const override
@@ -311,6 +325,14 @@ namespace mico { namespace objects {
             return nullptr;
         }
 
+        void trace( std::vector<const base *> &res ) const override
+        {
+            res.push_back( obj_.get( ) );
+            for( auto &p: params_ ) {
+                res.push_back( p.get( ) );
+            }
+        }
+
     private:
         objects::sptr   obj_;
         objects::slist  params_;
@@ -24,7 +24,7 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = type::GENERATOR;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         impl<type::GENERATOR>( )
         { }
@@ -120,13 +120,13 @@ namespace mico { namespace objects {
             static
             sptr make( objects::array::sptr obj )
             {
-                return std::make_shared<this_type>( obj, 1 );
+                return mico::make_shared<this_type>( obj, 1 );
             }
 
             static
             sptr make( objects::array::sptr obj, std::int64_t step )
             {
-                return std::make_shared<this_type>( obj, step );
+                return mico::make_shared<this_type>( obj, step );
             }
 
         private:
@@ -229,7 +229,7 @@ namespace mico { namespace objects {
             static
             sptr make( objects::table::sptr obj )
             {
-                return std::make_shared<this_type>( obj );
+                return mico::make_shared<this_type>( obj );
             }
 
         private:
@@ -329,13 +329,13 @@ namespace mico { namespace objects {
             static
             sptr make( objects::string::sptr obj, std::int64_t step )
             {
-                return std::make_shared<this_type>( obj, step );
+                return mico::make_shared<this_type>( obj, step );
             }
 
             static
             sptr make( objects::string::sptr obj )
             {
-                return std::make_shared<this_type>( obj, 1 );
+                return mico::make_shared<this_type>( obj, 1 );
             }
 
         };
@@ -365,13 +365,13 @@ namespace mico { namespace objects {
             static
             sptr make( objects::rstring::sptr obj, std::int64_t step )
             {
-                return std::make_shared<this_type>( obj, step );
+                return mico::make_shared<this_type>( obj, step );
             }
 
             static
             sptr make( objects::rstring::sptr obj )
             {
-                return std::make_shared<this_type>( obj, 1 );
+                return mico::make_shared<this_type>( obj, 1 );
             }
 
         };
@@ -443,7 +443,8 @@ namespace mico { namespace objects {
             objects::sptr get_val( ) override
             {
                 if( !end( ) ) {
-                    return object_type::make( id_ );
+                    last_ = object_type::reuse( last_, id_ );
+                    return last_;
                 }
                 return nullptr;
             }
@@ -462,13 +463,16 @@ namespace mico { namespace objects {
             static
             sptr make( value_type stop, value_type step )
             {
-                return std::make_shared<this_type>( stop, step );
+                return mico::make_shared<this_type>( stop, step );
             }
 
         private:
             ival_type  ival_;
             value_type step_ = 1;
             value_type id_   = 0;
+            /// the value of the previous step; it is used again if the
+            /// loop did not keep it
+            objects::sptr last_;
         };
 
         template <objects::type NumT>
@@ -535,7 +539,8 @@ namespace mico { namespace objects {
             objects::sptr get_val( ) override
             {
                 if( !end( ) ) {
-                    return object_type::make( id_ );
+                    last_ = object_type::reuse( last_, id_ );
+                    return last_;
                 }
                 return nullptr;
             }
@@ -548,14 +553,14 @@ namespace mico { namespace objects {
             static
             sptr make( value_type start, value_type stop, value_type step )
             {
-                return std::make_shared<this_type>( start, stop, step );
+                return mico::make_shared<this_type>( start, stop, step );
             }
 
             static
             sptr make( typename objects::intervals::obj<NumT>::sptr &obj,
                        value_type step )
             {
-                return std::make_shared<this_type>( obj->native( ).left( ),
+                return mico::make_shared<this_type>( obj->native( ).left( ),
                                                     obj->native( ).right( ),
                                                     step );
             }
@@ -564,6 +569,9 @@ namespace mico { namespace objects {
             ival_type  ival_;
             value_type step_ = 1;
             value_type id_   = 0;
+            /// the value of the previous step; it is used again if the
+            /// loop did not keep it
+            objects::sptr last_;
         };
 
         template <typename SliceT>
@@ -633,13 +641,13 @@ namespace mico { namespace objects {
             static
             sptr make( value_type obj )
             {
-                return std::make_shared<this_type>( obj, 1 );
+                return mico::make_shared<this_type>( obj, 1 );
             }
 
             static
             sptr make( value_type obj, std::int64_t step )
             {
-                return std::make_shared<this_type>( obj, step );
+                return mico::make_shared<this_type>( obj, step );
             }
 
         private:
@@ -11,7 +11,7 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = type::INF_OBJ;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         explicit
         impl<type::INF_OBJ>( bool negative )
@@ -33,8 +33,8 @@ namespace mico { namespace objects {
         static
         sptr make( bool negative )
         {
-            static auto neg = std::make_shared<this_type>(true);
-            static auto pos = std::make_shared<this_type>(false);
+            static auto neg = mico::make_shared<this_type>(true);
+            static auto pos = mico::make_shared<this_type>(false);
             return negative ? neg : pos;
         }
 
@@ -83,7 +83,7 @@ namespace mico { namespace objects {
             using object_type   = objects::impl<type_name>;
             using value_type    = typename object_type::value_type;
 
-            using sptr          = std::shared_ptr<this_type>;
+            using sptr          = mico::shared_ptr<this_type>;
             using interval_type = etool::intervals::interval<value_type>;
 
             obj<NumT>( value_type left, value_type right )
@@ -108,7 +108,7 @@ namespace mico { namespace objects {
             static
             sptr make( value_type left, value_type right )
             {
-                return std::make_shared<this_type>(left, right);
+                return mico::make_shared<this_type>(left, right);
             }
 
             objects::sptr clone( ) const override
@@ -17,9 +17,9 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = type::TABLE;
-        using sptr          = std::shared_ptr<this_type>;
+        using sptr          = mico::shared_ptr<this_type>;
         using cont          = impl<type::REFERENCE>;
-        using cont_sptr     = std::shared_ptr<cont>;
+        using cont_sptr     = mico::shared_ptr<cont>;
         using parents_list  = std::deque<sptr>;
 
         impl<type::MODULE>( environment::sptr e, const std::string &name )
@@ -75,7 +75,7 @@ namespace mico { namespace objects {
         static
         sptr make( environment::sptr env, const std::string &n )
         {
-            return std::make_shared<this_type>( env, n );
+            return mico::make_shared<this_type>( env, n );
         }
 
         std::size_t marked( ) const override
@@ -93,7 +93,7 @@ namespace mico { namespace objects {
 
         objects::sptr clone( ) const override
         {
-            auto res = std::make_shared<this_type>( env( ), name_ );
+            auto res = mico::make_shared<this_type>( env( ), name_ );
             for( auto &p: parents_ ) {
                 res->parents_.push_back(p);
             }
@@ -133,6 +133,13 @@ namespace mico { namespace objects {
             return ast::node::uptr( std::move( res ) );
         }
 
+        void trace( std::vector<const base *> &res ) const override
+        {
+            for( auto &p: parents_ ) {
+                res.push_back( p.get( ) );
+            }
+        }
+
     private:
         std::string     name_;
         parents_list    parents_;
@@ -10,7 +10,7 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = type::NULL_OBJ;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
         std::string str( ) const override
         {
             return "null";
@@ -18,7 +18,7 @@ namespace mico { namespace objects {
         static
         sptr make( )
         {
-            static auto val = std::make_shared<this_type>( );
+            static auto val = mico::make_shared<this_type>( );
             return val;
         }
 
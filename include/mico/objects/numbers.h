@@ -29,7 +29,7 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = TN;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         using value_type = typename type2object<TN>::native_type;
 
@@ -55,11 +55,27 @@ namespace mico { namespace objects {
             value_ = val;
         }
 
+        /// a number is changed only while nothing else holds it (see
+        /// 'reuse'), so the small integers are shared and live as long as
+        /// the process
         template <typename T>
         static
         sptr make( T val )
         {
-            return std::make_shared<this_type>( static_cast<value_type>(val) );
+            return make_value( static_cast<value_type>(val) );
+        }
+
+        /// 'tmp' gets 'val' if it is a number of this kind that nobody
+        /// else holds, a temporary of an expression or a loop; a new
+        /// number otherwise
+        static
+        objects::sptr reuse( const objects::sptr &tmp, value_type val )
+        {
+            if( tmp.use_count( ) == 1 && tmp->get_type( ) == TN ) {
+                static_cast<this_type *>( tmp.get( ) )->value_ = val;
+                return tmp;
+            }
+            return make_value( val );
         }
 
         static
@@ -91,6 +107,36 @@ namespace mico { namespace objects {
 
     private:
 
+        static const std::int64_t cache_min = -128;
+        static const std::int64_t cache_max = 1024;
+
+        static
+        sptr make_value( std::int64_t val )
+        {
+            if( val >= cache_min && val < cache_max ) {
+                static const std::vector<sptr> cache = make_cache( );
+                return cache[static_cast<std::size_t>(val - cache_min)];
+            }
+            return mico::make_shared<this_type>( val );
+        }
+
+        static
+        sptr make_value( double val )
+        {
+            return mico::make_shared<this_type>( val );
+        }
+
+        static
+        std::vector<sptr> make_cache( )
+        {
+            std::vector<sptr> res;
+            res.reserve( static_cast<std::size_t>(cache_max - cache_min) );
+            for( auto i = cache_min; i < cache_max; ++i ) {
+                res.emplace_back( mico::make_shared<this_type>( i ) );
+            }
+            return res;
+        }
+
         value_type value_;
     };
 
@@ -19,7 +19,7 @@ namespace mico { namespace objects {
 
         static const type type_value = type::QUOTE;
 
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
         using value_type = ast::node::sptr;
 
         std::string str( ) const override
@@ -50,12 +50,12 @@ namespace mico { namespace objects {
         static
         sptr make( ast::node::uptr val )
         {
-            return std::make_shared<this_type>( std::move(val) );
+            return mico::make_shared<this_type>( std::move(val) );
         }
 
         objects::sptr clone( ) const override
         {
-            return std::make_shared<this_type>( value_ );
+            return mico::make_shared<this_type>( value_ );
         }
 
         ast::node::uptr to_ast( tokens::position pos ) const override
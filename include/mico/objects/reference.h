@@ -15,22 +15,27 @@ namespace mico { namespace objects {
 
         static const type type_value = type::REFERENCE;
 
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
         using value_type = objects::sptr;
 
         impl<type::REFERENCE>( const environment *my_env,
                                value_type val, bool var )
             :my_env_(my_env)
+            ,guard_(guard_of(my_env))
             ,value_(val)
         {
-            value_->mark_in( my_env_ );
+            if( my_env_ ) {
+                value_->mark_in( my_env_ );
+            }
             marked_ = val->marked( );
             set_mutable( var );
         }
 
         ~impl<type::REFERENCE>( )
         {
-            value_->unmark_in( my_env_ );
+            if( alive( ) ) {
+                value_->unmark_in( my_env_ );
+            }
         }
 
         std::string str( ) const override
@@ -69,32 +74,47 @@ namespace mico { namespace objects {
         void set_value( const environment * /*my_env*/, value_type val )
         {
             if( value_ != val ) {
+                bool lock = alive( );
                 //// unlock
-                value_->unmark_in( my_env_ );
+                if( lock ) {
+                    value_->unmark_in( my_env_ );
+                }
 
                 ///replace lock
                 value_ = val;
                 //my_env_ = my_env;
-                value_->mark_in( my_env_ );
+                if( lock ) {
+                    value_->mark_in( my_env_ );
+                }
                 marked_ = val->marked( );
             }
         }
 
+        /// the environment releases the lock itself when it dies.
+        /// A reference that lives longer does not touch it anymore
+        void detach( )
+        {
+            if( alive( ) ) {
+                value_->unmark_in( my_env_ );
+            }
+            my_env_ = nullptr;
+        }
+
         static
         sptr make_var( const environment *my_env, value_type val )
         {
-            return std::make_shared<this_type>(my_env, val, true);
+            return mico::make_shared<this_type>(my_env, val, true);
         }
 
         static
         sptr make_const( const environment *my_env, value_type val )
         {
-            return std::make_shared<this_type>(my_env, val, false);
+            return mico::make_shared<this_type>(my_env, val, false);
         }
 
         const environment *env( ) const
         {
-            return my_env_;
+            return alive( ) ? my_env_ : nullptr;
         }
 
         bool mark_in( const environment *e ) override
@@ -119,7 +139,7 @@ namespace mico { namespace objects {
 
         objects::sptr clone( ) const override
         {
-            auto res = std::make_shared<this_type>( my_env_,
+            auto res = mico::make_shared<this_type>( env( ),
                                                     value_->clone( ),
                                                     is_mutable( ) );
             return res;
@@ -135,9 +155,25 @@ namespace mico { namespace objects {
             return value_->to_ast( pos );
         }
 
+        void trace( std::vector<const base *> &res ) const override
+        {
+            res.push_back( value_.get( ) );
+        }
+
     private:
-        const environment  *my_env_;
-        value_type          value_;
+
+        /// defined in environment.h
+        static
+        mico::weak_ptr<environment> guard_of( const environment *e );
+
+        bool alive( ) const
+        {
+            return my_env_ && !guard_.expired( );
+        }
+
+        const environment          *my_env_;
+        mico::weak_ptr<environment>  guard_;
+        value_type                  value_;
         std::size_t         marked_ = 0;
     };
 
@@ -13,7 +13,7 @@ namespace mico { namespace objects {
     public:
         static const type type_value = type::RETURN;
 
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         using value_type = objects::sptr;
 
@@ -41,12 +41,12 @@ namespace mico { namespace objects {
         static
         sptr make( objects::sptr res )
         {
-            return std::make_shared<this_type>( res );
+            return mico::make_shared<this_type>( res );
         }
 
         objects::sptr clone( ) const override
         {
-            return std::make_shared<this_type>( value_ );
+            return mico::make_shared<this_type>( value_ );
         }
 
         ast::node::uptr to_ast( tokens::position pos ) const override
@@ -58,6 +58,11 @@ namespace mico { namespace objects {
             return ast::node::uptr( std::move( res ) );
         }
 
+        void trace( std::vector<const base *> &res ) const override
+        {
+            res.push_back( value_.get( ) );
+        }
+
     private:
         value_type value_;
     };
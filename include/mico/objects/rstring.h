@@ -24,7 +24,7 @@ namespace mico { namespace objects {
 
         static const type type_value = type::RSTRING;
 
-        using sptr        = std::shared_ptr<this_type>;
+        using sptr        = mico::shared_ptr<this_type>;
         using value_type  = internal_type;
         using symbol_type = std::uint8_t;
 
@@ -93,7 +93,7 @@ namespace mico { namespace objects {
         static
         sptr make( value_type val )
         {
-            return std::make_shared<this_type>( std::move(val) );
+            return mico::make_shared<this_type>( std::move(val) );
         }
 
         bool equal( const base *other ) const override
@@ -107,7 +107,7 @@ namespace mico { namespace objects {
 
         objects::sptr clone( ) const override
         {
-            return std::make_shared<this_type>( value_ );
+            return mico::make_shared<this_type>( value_ );
         }
 
         ast::node::uptr to_ast( tokens::position pos ) const override
@@ -20,7 +20,7 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = TName;
-        using sptr                   = std::shared_ptr<this_type>;
+        using sptr                   = mico::shared_ptr<this_type>;
         using value_type             = typename T::sptr;
 
         explicit
@@ -132,7 +132,7 @@ namespace mico { namespace objects {
         using this_type = impl<type::SSLICE>;
     public:
 
-        using sptr       = std::shared_ptr<this_type>;
+        using sptr       = mico::shared_ptr<this_type>;
         using slice_type = this_type;
 
         impl<type::SSLICE>( objects::string::sptr obj,
@@ -152,14 +152,14 @@ namespace mico { namespace objects {
         sptr make( objects::string::sptr obj,
                    std::size_t start, std::size_t stop )
         {
-            auto val = std::make_shared<this_type>( obj, start, stop );
+            auto val = mico::make_shared<this_type>( obj, start, stop );
             return val;
         }
 
         static
         sptr make( sptr obj, std::size_t start, std::size_t stop )
         {
-            auto val = std::make_shared<this_type>( obj->value( ),
+            auto val = mico::make_shared<this_type>( obj->value( ),
                                                     start, stop );
             return val;
         }
@@ -184,7 +184,7 @@ namespace mico { namespace objects {
         using this_type = impl<type::ASLICE>;
     public:
 
-        using sptr       = std::shared_ptr<this_type>;
+        using sptr       = mico::shared_ptr<this_type>;
         using slice_type = this_type;
 
         impl<type::ASLICE>( objects::array::sptr obj,
@@ -206,14 +206,14 @@ namespace mico { namespace objects {
         sptr make( objects::array::sptr obj,
                    std::size_t start, std::size_t stop )
         {
-            auto val = std::make_shared<this_type>( obj, start, stop );
+            auto val = mico::make_shared<this_type>( obj, start, stop );
             return val;
         }
 
         static
         sptr make( sptr obj, std::size_t start, std::size_t stop )
         {
-            auto val = std::make_shared<this_type>( obj->value( ),
+            auto val = mico::make_shared<this_type>( obj->value( ),
                                                     start, stop );
             return val;
         }
@@ -229,7 +229,7 @@ namespace mico { namespace objects {
         using this_type = impl<type::RSLICE>;
     public:
 
-        using sptr       = std::shared_ptr<this_type>;
+        using sptr       = mico::shared_ptr<this_type>;
         using slice_type = this_type;
 
         impl<type::RSLICE>( objects::rstring::sptr obj,
@@ -250,14 +250,14 @@ namespace mico { namespace objects {
         sptr make( objects::rstring::sptr obj,
                    std::size_t start, std::size_t stop )
         {
-            auto val = std::make_shared<this_type>( obj, start, stop );
+            auto val = mico::make_shared<this_type>( obj, start, stop );
             return val;
         }
 
         static
         sptr make( sptr obj, std::size_t start, std::size_t stop )
         {
-            auto val = std::make_shared<this_type>( obj->value( ),
+            auto val = mico::make_shared<this_type>( obj->value( ),
                                                     start, stop );
             return val;
         }
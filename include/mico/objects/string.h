@@ -23,7 +23,7 @@ namespace mico { namespace objects {
 
         static const type type_value = type::STRING;
 
-        using sptr        = std::shared_ptr<this_type>;
+        using sptr        = mico::shared_ptr<this_type>;
         using value_type  = internal_type;
         using symbol_type = value_type::value_type;
 
@@ -96,14 +96,18 @@ namespace mico { namespace objects {
         static
         sptr make( value_type val )
         {
-            return std::make_shared<this_type>( std::move(val) );
+            if( val.empty( ) ) {
+                static const sptr empty = mico::make_shared<this_type>( val );
+                return empty;
+            }
+            return mico::make_shared<this_type>( std::move(val) );
         }
 
         static
         sptr make( system_type val )
         {
             auto internal = charset::encoding::from_file( val );
-            return std::make_shared<this_type>( std::move(internal) );
+            return mico::make_shared<this_type>( std::move(internal) );
         }
 
         bool equal( const base *other ) const override
@@ -117,7 +121,7 @@ namespace mico { namespace objects {
 
         objects::sptr clone( ) const override
         {
-            return std::make_shared<this_type>( value_ );
+            return mico::make_shared<this_type>( value_ );
         }
 
         ast::node::uptr to_ast( tokens::position pos ) const override
@@ -34,9 +34,9 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = type::TABLE;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
         using cont = impl<type::REFERENCE>;
-        using cont_sptr = std::shared_ptr<cont>;
+        using cont_sptr = mico::shared_ptr<cont>;
 
         using value_type = std::unordered_map<objects::sptr, cont_sptr,
                                               hash_helper, equal_helper>;
@@ -139,7 +139,7 @@ namespace mico { namespace objects {
         static
         sptr make( environment::sptr env )
         {
-            return std::make_shared<this_type>( env );
+            return mico::make_shared<this_type>( env );
         }
 
         std::size_t marked( ) const override
@@ -180,6 +180,14 @@ namespace mico { namespace objects {
             }
         }
 
+        void trace( std::vector<const base *> &res ) const override
+        {
+            for( auto &v: value_ ) {
+                res.push_back( v.first.get( ) );
+                res.push_back( v.second->value( ).get( ) );
+            }
+        }
+
     private:
         value_type value_;
     };
@@ -11,7 +11,7 @@ namespace mico { namespace objects {
     public:
 
         static const type type_value = type::TYPE_OBJ;
-        using sptr = std::shared_ptr<this_type>;
+        using sptr = mico::shared_ptr<this_type>;
 
         explicit
         impl<type::TYPE_OBJ>( objects::type tt )
@@ -33,7 +33,7 @@ namespace mico { namespace objects {
         static
         sptr make( objects::type tt )
         {
-            auto val = std::make_shared<this_type>( tt );
+            auto val = mico::make_shared<this_type>( tt );
             return val;
         }
 
@@ -3,6 +3,8 @@
 
 #include <map>
 #include <set>
+#include <array>
+#include <vector>
 #include <memory>
 #include <functional>
 #include <fstream>
@@ -12,6 +14,9 @@
 #include "mico/ast.h"
 #include "mico/expressions.h"
 #include "mico/statements.h"
+#include "mico/module_cache.h"
+#include "mico/micoc.h"
+#include "mico/module_prefetch.h"
 
 namespace mico {
 
@@ -54,36 +59,46 @@ namespace mico {
     public:
 
         using expression_uptr = ast::expression::uptr;
-        using token_iterator  = lexer::token_list::const_iterator;
+        using token_stream    = lexer::stream;
         using token_type      = lexer::token_type;
         using token_info      = lexer::token_info;
-        using nuds_call       = std::function<expression_uptr( )>;
-        using leds_call       = std::function<expression_uptr(expression_uptr)>;
-
-        using nuds_map        = std::map<token_type, nuds_call>;
-        using leds_map        = std::map<token_type, leds_call>;
+        using nud_call        = expression_uptr (*)( parser * );
+        using led_call        = expression_uptr (*)( parser *,
+                                                     expression_uptr );
 
         using errors_list     = std::vector<std::string>;
         using special_map     = std::map<token_type, special_token>;
 
         using precedence      = operations::precedence;
 
+        /// what a token does at the beginning of an expression (nud),
+        /// after a left operand (led) and how strong the led binds
+        struct rule {
+            nud_call    nud  = nullptr;
+            led_call    led  = nullptr;
+            precedence  prec = precedence::LOWEST;
+        };
+
+        static const std::size_t rules_size =
+                static_cast<std::size_t>(token_type::LAST_VISIBLE) + 1;
+
+        using rule_table = std::array<rule, rules_size>;
+
+        /// tokens are taken from the stream while the parser goes;
+        /// the parser looks at two of them at once
         explicit
-        parser( lexer lex )
-            :lexer_(std::move(lex))
+        parser( token_stream tokens )
+            :tokens_(std::move(tokens))
         {
             reset( );
-            fill_nuds( );
-            fill_leds( );
             fill_special( );
         }
 
         void reset( )
         {
-            cur_ = peek_ = lexer_.begin( );
-            if( peek_ != lexer_.end( ) ) {
-                ++peek_;
-            }
+            cur_ = 0;
+            ring_[0] = tokens_.next( );
+            ring_[1] = tokens_.next( );
             errors_.clear( );
         }
 
@@ -94,162 +109,201 @@ namespace mico {
             special_[token_type::ELIPSIS].disabled  = true;
         }
 
-        void fill_nuds( )
+        static
+        const rule &get_rule( token_type tt )
+        {
+            static const rule_table table = make_rules( );
+            return table[static_cast<std::size_t>(tt)];
+        }
+
+        static
+        rule_table make_rules( )
+        {
+            rule_table res;
+            fill_nuds( res );
+            fill_leds( res );
+            fill_precedence( res );
+            return res;
+        }
+
+        static
+        rule &get_rule( rule_table &table, token_type tt )
         {
-            nuds_[token_type::IDENT]   = [this]( ) { return parse_ident( );  };
-            nuds_[token_type::INFIN]   = [this]( ) { return parse_inf( );    };
-            nuds_[token_type::STRING]  = [this]( ) { return parse_string( ); };
-            nuds_[token_type::RSTRING] = [this]( ) { return parse_rstring( );};
-            nuds_[token_type::FLOAT]   = [this]( ) { return parse_float( );  };
-            nuds_[token_type::LPAREN]  = [this]( ) { return parse_paren( );  };
+            return table[static_cast<std::size_t>(tt)];
+        }
 
-            nuds_[token_type::BOOL_TRUE]  = [this]( ) { return parse_bool( ); };
-            nuds_[token_type::BOOL_FALSE] = [this]( ) { return parse_bool( ); };
-            nuds_[token_type::FOR]        = [this]( ) { return parse_for( );  };
+        static
+        void fill_nuds( rule_table &r )
+        {
+            using TT = token_type;
+            using EP = expression_uptr;
 
-            nuds_[token_type::IF] =
-                    [this]( ) {
-                        return parse_if( false );
+            get_rule( r, TT::IDENT ).nud =
+                    []( parser *p ) -> EP { return p->parse_ident( ); };
+            get_rule( r, TT::INFIN ).nud =
+                    []( parser *p ) -> EP { return p->parse_inf( ); };
+            get_rule( r, TT::STRING ).nud =
+                    []( parser *p ) -> EP { return p->parse_string( ); };
+            get_rule( r, TT::RSTRING ).nud =
+                    []( parser *p ) -> EP { return p->parse_rstring( ); };
+            get_rule( r, TT::FLOAT ).nud =
+                    []( parser *p ) -> EP { return p->parse_float( ); };
+            get_rule( r, TT::LPAREN ).nud =
+                    []( parser *p ) -> EP { return p->parse_paren( ); };
+
+            get_rule( r, TT::BOOL_TRUE ).nud =
+                    []( parser *p ) -> EP { return p->parse_bool( ); };
+            get_rule( r, TT::BOOL_FALSE ).nud =
+                    []( parser *p ) -> EP { return p->parse_bool( ); };
+            get_rule( r, TT::FOR ).nud =
+                    []( parser *p ) -> EP { return p->parse_for( ); };
+
+            get_rule( r, TT::IF ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_if( false );
                     };
 
-            nuds_[token_type::UNLESS] =
-                    [this]( ) {
-                        return parse_if( true );
+            get_rule( r, TT::UNLESS ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_if( true );
                     };
 
-            nuds_[token_type::MOD_MUT] =
-                    [this]( ) {
-                        return parse_mut( true );
+            get_rule( r, TT::MOD_MUT ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_mut( true );
                     };
-            nuds_[token_type::MOD_CONST] =
-                    [this]( ) {
-                        return parse_mut( false );
+            get_rule( r, TT::MOD_CONST ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_mut( false );
                     };
 
-            nuds_[token_type::CHARACTER]  =
-                    [this]( ) {
-                        return parse_char( );
+            get_rule( r, TT::CHARACTER ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_char( );
                     };
 
-            nuds_[token_type::FUNCTION]   =
-                    [this]( ) {
-                        return parse_function( );
+            get_rule( r, TT::FUNCTION ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_function( );
                     };
-            nuds_[token_type::MODULE]   =
-                    [this]( ) {
-                        return parse_module( nullptr );
+            get_rule( r, TT::MODULE ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_module( nullptr );
                     };
 
 #if !defined(DISABLE_MACRO) || !DISABLE_MACRO
-            nuds_[token_type::MACRO]   =
-                    [this]( ) {
-                        return parse_macro( );
+            get_rule( r, TT::MACRO ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_macro( );
                     };
 
-            nuds_[token_type::QUOTE]   =
-                    [this]( ) {
-                        return parse_quote( );
+            get_rule( r, TT::QUOTE ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_quote( );
                     };
 
-            nuds_[token_type::UNQUOTE]   =
-                    [this]( ) {
-                        return parse_unquote( );
+            get_rule( r, TT::UNQUOTE ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_unquote( );
                     };
 #endif
 
-            nuds_[token_type::LBRACE]   =
-                    [this]( ) {
-                        return parse_table( );
+            get_rule( r, TT::LBRACE ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_table( );
                     };
 
-            nuds_[token_type::LBRACKET] =
-                    [this]( ) {
-                        return parse_array( );
+            get_rule( r, TT::LBRACKET ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_array( );
                     };
-            nuds_[token_type::ELIPSIS] =
-                    [this]( ) {
-                        return parse_elipsis( );
+            get_rule( r, TT::ELIPSIS ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_elipsis( );
                     };
 
-            nuds_[token_type::MINUS]    =
-            nuds_[token_type::BANG]     =
-            nuds_[token_type::TILDA]    =
-            nuds_[token_type::ASTERISK] =
-                    [this]( ) {
-                        return parse_prefix( );
+            get_rule( r, TT::MINUS ).nud    =
+            get_rule( r, TT::BANG ).nud     =
+            get_rule( r, TT::TILDA ).nud    =
+            get_rule( r, TT::ASTERISK ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_prefix( );
                     };
 
-            nuds_[token_type::INT_BIN] =
-            nuds_[token_type::INT_TER] =
-            nuds_[token_type::INT_OCT] =
-            nuds_[token_type::INT_DEC] =
-            nuds_[token_type::INT_HEX] =
-                    [this]( ) {
-                        return parse_int( );
+            get_rule( r, TT::INT_BIN ).nud =
+            get_rule( r, TT::INT_TER ).nud =
+            get_rule( r, TT::INT_OCT ).nud =
+            get_rule( r, TT::INT_DEC ).nud =
+            get_rule( r, TT::INT_HEX ).nud =
+                    []( parser *p ) -> EP {
+                        return p->parse_int( );
                     };
 
-            nuds_[token_type::END_OF_FILE] =
-                    [this]( ) {
-                        return unexpected_eof( );
+            get_rule( r, TT::END_OF_FILE ).nud =
+                    []( parser *p ) -> EP {
+                        return p->unexpected_eof( );
                     };
         }
 
-        void fill_leds( )
+        static
+        void fill_leds( rule_table &r )
         {
+            using TT = token_type;
             using EP = expression_uptr;
-            leds_[token_type::DOT]          =
-            leds_[token_type::MINUS]        =
-            leds_[token_type::PLUS]         =
-            leds_[token_type::ASTERISK]     =
-            leds_[token_type::ASSIGN]       =
-            leds_[token_type::SLASH]        =
-            leds_[token_type::PERCENT]      =
-            leds_[token_type::LT]           =
-            leds_[token_type::GT]           =
-            leds_[token_type::LT_EQ]        =
-            leds_[token_type::GT_EQ]        =
-            leds_[token_type::EQ]           =
-            leds_[token_type::NOT_EQ]       =
-            leds_[token_type::LOGIC_OR]     =
-            leds_[token_type::LOGIC_AND]    =
-            leds_[token_type::BIT_OR]       =
-            leds_[token_type::BIT_XOR]      =
-            leds_[token_type::BIT_AND]      =
-            leds_[token_type::SHIFT_LEFT]   =
-            leds_[token_type::SHIFT_RIGHT]  =
-            leds_[token_type::DOTDOT]       =
-            leds_[token_type::OP_IN]        =
-                    [this]( EP e ) {
-                        return parse_infix(std::move(e));
+
+            get_rule( r, TT::DOT ).led          =
+            get_rule( r, TT::MINUS ).led        =
+            get_rule( r, TT::PLUS ).led         =
+            get_rule( r, TT::ASTERISK ).led     =
+            get_rule( r, TT::ASSIGN ).led       =
+            get_rule( r, TT::SLASH ).led        =
+            get_rule( r, TT::PERCENT ).led      =
+            get_rule( r, TT::LT ).led           =
+            get_rule( r, TT::GT ).led           =
+            get_rule( r, TT::LT_EQ ).led        =
+            get_rule( r, TT::GT_EQ ).led        =
+            get_rule( r, TT::EQ ).led           =
+            get_rule( r, TT::NOT_EQ ).led       =
+            get_rule( r, TT::LOGIC_OR ).led     =
+            get_rule( r, TT::LOGIC_AND ).led    =
+            get_rule( r, TT::BIT_OR ).led       =
+            get_rule( r, TT::BIT_XOR ).led      =
+            get_rule( r, TT::BIT_AND ).led      =
+            get_rule( r, TT::SHIFT_LEFT ).led   =
+            get_rule( r, TT::SHIFT_RIGHT ).led  =
+            get_rule( r, TT::DOTDOT ).led       =
+            get_rule( r, TT::OP_IN ).led        =
+                    []( parser *p, EP e ) -> EP {
+                        return p->parse_infix(std::move(e));
                     };
-            leds_[token_type::LPAREN]   =
-                    [this]( EP e ) {
-                        return parse_call(std::move(e));
+            get_rule( r, TT::LPAREN ).led   =
+                    []( parser *p, EP e ) -> EP {
+                        return p->parse_call(std::move(e));
                     };
-            leds_[token_type::LBRACKET]   =
-                    [this]( EP e ) {
-                        return parse_index(std::move(e));
+            get_rule( r, TT::LBRACKET ).led   =
+                    []( parser *p, EP e ) -> EP {
+                        return p->parse_index(std::move(e));
                     };
 
-            leds_[token_type::IF] =
-                    [this]( EP e ) {
-                        return parse_if_infix( std::move(e), false );
+            get_rule( r, TT::IF ).led =
+                    []( parser *p, EP e ) -> EP {
+                        return p->parse_if_infix( std::move(e), false );
                     };
 
-            leds_[token_type::UNLESS] =
-                    [this]( EP e ) {
-                        return parse_if_infix( std::move(e), true );
+            get_rule( r, TT::UNLESS ).led =
+                    []( parser *p, EP e ) -> EP {
+                        return p->parse_if_infix( std::move(e), true );
                     };
 
         }
 
         static
-        operations::precedence get_precedence( token_type tt )
+        void fill_precedence( rule_table &r )
         {
             using TT = token_type;
             using OP = operations::precedence;
 
-            static const std::map<TT, OP> val = {
+            static const std::pair<TT, OP> val[ ] = {
                 { TT::IF,           OP::INFIXIF     },
                 { TT::UNLESS,       OP::INFIXIF     },
                 { TT::ASSIGN,       OP::ASSIGN      },
@@ -278,11 +332,15 @@ namespace mico {
                 { TT::OP_IN,        OP::EQUALS      },
             };
 
-            auto f = val.find( tt );
-            if( f !=  val.end( ) ){
-                return f->second;
+            for( auto &v: val ) {
+                get_rule( r, v.first ).prec = v.second;
             }
-            return OP::LOWEST;
+        }
+
+        static
+        operations::precedence get_precedence( token_type tt )
+        {
+            return get_rule( tt ).prec;
         }
 
         ////////////// errors ///////
@@ -301,13 +359,14 @@ namespace mico {
             errors_.emplace_back(oss.str( ));
         }
 
-        void error_open_file( const std::string &path,
-                              const std::string &err )
+        static
+        std::string error_open_file( const std::string &path,
+                                     const std::string &err )
         {
             std::ostringstream oss;
             oss << "parser error: '" << path
                 << "' " << err;
-            errors_.emplace_back(oss.str( ));
+            return oss.str( );
         }
 
         void error_character( )
@@ -370,21 +429,14 @@ namespace mico {
 
         /////////////////////////////
 
-        static
-        const token_info &eof_token( )
-        {
-            static const token_info eof_value( token_type::END_OF_FILE );
-            return eof_value;
-        }
-
         const token_info &current( ) const
         {
-            return (cur_ == lexer_.end( )) ? eof_token( ) : *cur_;
+            return ring_[cur_];
         }
 
         const token_info &peek( ) const
         {
-            return (peek_ == lexer_.end( )) ? eof_token( ) : *peek_;
+            return ring_[cur_ ^ 1];
         }
 
         precedence peek_precedence( ) const
@@ -415,16 +467,13 @@ namespace mico {
 
         void advance( )
         {
-            cur_ = peek_;
-            if( peek_ != lexer_.end( ) ) {
-                ++peek_;
-            }
+            ring_[cur_] = tokens_.next( );
+            cur_ ^= 1;
         }
 
         bool eof( ) const
         {
-            return (cur_ == lexer_.end( ))
-                || (cur_->ident.name == token_type::END_OF_FILE );
+            return current( ).ident.name == token_type::END_OF_FILE;
         }
 
         const errors_list &errors( ) const
@@ -451,17 +500,15 @@ namespace mico {
         bool is_current_expression(  ) const
         {
             if( !is_current( token_type::END_OF_FILE ) ) {
-                auto nud = nuds_.find( current( ).ident.name );
-                return nud != nuds_.end( );
+                return get_rule( current( ).ident.name ).nud != nullptr;
             }
             return false;
         }
 
         bool is_peek_expression(  ) const
         {
-            if( !is_current( token_type::END_OF_FILE ) ) {
-                auto nud = nuds_.find( peek( ).ident.name );
-                return nud != nuds_.end( );
+            if( !is_peek( token_type::END_OF_FILE ) ) {
+                return get_rule( peek( ).ident.name ).nud != nullptr;
             }
             return false;
         }
@@ -744,7 +791,11 @@ namespace mico {
                     }
                 } else if( expect_peek( token_type::RBRACE, false ) ) {
                     break;
-                } else if( failed( ) ) {
+                } else {
+                    /// the same expression would be parsed again
+                    if( !failed( ) ) {
+                        error_expect( token_type::RBRACE );
+                    }
                     return nullptr;
                 }
             } while( true );
@@ -849,7 +900,7 @@ namespace mico {
         {
             using ident_type = ast::expressions::ident;
 
-            auto res = ident_type::make(current( ).ident.literal );
+            auto res = ident_type::make( current( ).ident.value( ) );
 
             if( (peek( ).ident.name == token_type::LPAREN) ) {
                 advance( );
@@ -867,7 +918,8 @@ namespace mico {
 
         ast::expressions::character::uptr parse_char( )
         {
-            auto res = charset::encoding::from_file( current( ).ident.literal );
+            auto value = current( ).ident.value( );
+            auto res   = charset::encoding::from_file( value );
             if( res.size( ) != 1 ) {
                 error_character( );
                 return nullptr;
@@ -977,36 +1029,35 @@ namespace mico {
         {
             ast::expression::uptr left;
 
-            auto nud = nuds_.find( current( ).ident.name );
-            if( nud == nuds_.end( ) ) {
+            auto nud = get_rule( current( ).ident.name ).nud;
+            if( !nud ) {
                 error_no_prefix( );
                 return nullptr;
             }
 
-            left = nud->second( );
+            left = nud( this );
             if( !left ) {
                 return ast::expression::uptr( );
             }
 
-            auto pp = peek_precedence( );
-            auto pt = peek( ).ident.name;
+            auto *pr = &get_rule( peek( ).ident.name );
 
-            while( (pt != token_type::SEMICOLON) && (p < pp) ) {
-
-                auto led = leds_.find( pt );
-                if( led == leds_.end( ) ) {
+            while( (peek( ).ident.name != token_type::SEMICOLON) &&
+                   (p < pr->prec) )
+            {
+                auto led = pr->led;
+                if( !led ) {
                     error_no_suffix( );
                     return nullptr;
                 }
 
                 advance( );
-                left = led->second(std::move(left));
+                left = led( this, std::move(left) );
                 if( !left ) {
                     return nullptr;
                 }
 
-                pp = peek_precedence( );
-                pt = peek( ).ident.name;
+                pr = &get_rule( peek( ).ident.name );
             }
 
             return left;
@@ -1088,11 +1139,12 @@ namespace mico {
             return res;
         }
 
+        /// a bare 'return' leaves the '}' or ';' after it to its scope
         ast::statements::ret::uptr parse_return( )
         {
             using res_type = ast::statements::ret;
-            advance( );
-            if( is_current_expression( ) ) {
+            if( is_peek_expression( ) ) {
+                advance( );
                 auto expr = parse_expression( precedence::LOWEST );
                 return res_type::make( std::move(expr ) );
             } else {
@@ -1124,6 +1176,10 @@ namespace mico {
             TD tdc( get_spec_tok( token_type::CONTINUE ), true );
 
             if( expect_peek( token_type::LBRACE, false ) ) {
+                if( lazy_ ) {
+                    res->set_body( skip_body( ) );
+                    return res;
+                }
                 advance( );
                 res->set_body( parse_scope( ) );
                 return res;
@@ -1135,6 +1191,170 @@ namespace mico {
             //return nullptr;
         }
 
+        /// a token that can end an expression; an 'if' after it is infix
+        static
+        bool ends_operand( token_type tt )
+        {
+            switch( tt ) {
+            case token_type::INT_BIN:
+            case token_type::INT_TER:
+            case token_type::INT_OCT:
+            case token_type::INT_DEC:
+            case token_type::INT_HEX:
+            case token_type::FLOAT:
+            case token_type::IDENT:
+            case token_type::STRING:
+            case token_type::RSTRING:
+            case token_type::CHARACTER:
+            case token_type::BOOL_TRUE:
+            case token_type::BOOL_FALSE:
+            case token_type::RPAREN:
+            case token_type::RBRACKET:
+            case token_type::RBRACE:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /// the lazy mode keeps the text of a body and parses it when the
+        /// body is needed; here only the braces are counted.
+        /// 'break' and 'continue' are checked as well: a function that
+        /// has no 'for' before them can not have them in a loop, and a
+        /// program that the eager mode rejects must not run. So is
+        /// 'x if( c ) { ... }': such 'if' is an infix one, its braces are
+        /// a table and can not have statements or an 'else' after them.
+        /// 'current' is the opening brace, the closing one at the end
+        ast::node::uptr skip_body( )
+        {
+            auto open = current( );
+            std::size_t depth = 1;
+            std::size_t paren = 0;
+
+            /// depth of the body of every function around and the number
+            /// of 'for's in it
+            std::vector<std::pair<std::size_t, std::size_t> > fns;
+            fns.emplace_back( depth, 0 );
+
+            /// 1: after 'fn', 2: in its parameters, 3: after them
+            int fn_state = 0;
+            std::size_t fn_paren = 0;
+
+            /// paren level + 1 of an infix 'if' and depth of the braces
+            /// after its condition
+            std::size_t infix_if = 0;
+            std::vector<std::size_t> infix_braces;
+            bool infix_end = false;
+
+            auto prev = current( ).ident.name;
+            while( depth > 0 && !eof( ) ) {
+                advance( );
+                auto tt = current( ).ident.name;
+                bool in_table = !infix_braces.empty( ) &&
+                                 infix_braces.back( ) == depth;
+                if( infix_end ) {
+                    infix_end = false;
+                    if( tt == token_type::ELSE || tt == token_type::ELIF ) {
+                        error_no_prefix( );
+                    }
+                }
+                switch( tt ) {
+                case token_type::LBRACE:
+                    ++depth;
+                    if( fn_state == 3 ) {
+                        fns.emplace_back( depth, 0 );
+                    }
+                    if( infix_if == paren + 1 ) {
+                        if( prev == token_type::RPAREN ) {
+                            infix_braces.push_back( depth );
+                        }
+                        infix_if = 0;
+                    }
+                    break;
+                case token_type::RBRACE:
+                    if( fns.size( ) > 1 && fns.back( ).first == depth ) {
+                        fns.pop_back( );
+                    }
+                    if( !infix_braces.empty( ) &&
+                         infix_braces.back( ) == depth ) {
+                        infix_braces.pop_back( );
+                        infix_end = true;
+                    }
+                    --depth;
+                    break;
+                case token_type::IF:
+                case token_type::UNLESS:
+                    if( ends_operand( prev ) ) {
+                        infix_if = paren + 1;
+                    }
+                    break;
+                case token_type::SEMICOLON:
+                    infix_if = 0;
+                    break;
+                case token_type::LPAREN:
+                    ++paren;
+                    break;
+                case token_type::RPAREN:
+                    paren -= ( paren > 0 ) ? 1 : 0;
+                    break;
+                case token_type::FOR:
+                    ++fns.back( ).second;
+                    break;
+                case token_type::BREAK:
+                case token_type::CONTINUE:
+                    if( in_table ) {
+                        error_no_prefix( );
+                    } else if( fns.back( ).second == 0 ) {
+                        error_unexpect( );
+                    }
+                    break;
+                case token_type::LET:
+                case token_type::VAR:
+                case token_type::RETURN:
+                    if( in_table ) {
+                        error_no_prefix( );
+                    }
+                    break;
+                default:
+                    break;
+                }
+
+                if( tt == token_type::FUNCTION ) {
+                    fn_state = 1;
+                } else if( fn_state == 1 && tt == token_type::IDENT ) {
+                    /// fn name( ... )
+                } else if( fn_state == 1 && tt == token_type::LPAREN ) {
+                    fn_state = 2;
+                    fn_paren = paren;
+                } else if( fn_state == 2 ) {
+                    if( tt == token_type::RPAREN && paren + 1 == fn_paren ) {
+                        fn_state = 3;
+                    }
+                } else {
+                    fn_state = 0;
+                }
+                prev = tt;
+            }
+
+            auto src        = tokens_.get_source( );
+            auto begin      = open.begin + 1;
+            auto end        = current( ).begin;
+            auto line       = open.where.line;
+            auto line_begin = open.begin - open.where.pos;
+
+            auto res = ast::expressions::lazy::make(
+                [src, begin, end, line, line_begin]( errors_list &errs ) {
+                    parser pp( token_stream( src, begin, end,
+                                             line, line_begin ) );
+                    pp.lazy_ = true;
+                    auto body = pp.parse_scope( );
+                    errs = pp.errors( );
+                    return ast::node::uptr( std::move(body) );
+                } );
+            res->set_pos( open.where );
+            return ast::node::uptr( std::move(res) );
+        }
+
 #if !defined(DISABLE_MACRO) || !DISABLE_MACRO
 
         ast::statement::uptr parse_macro_state(  )
@@ -1255,8 +1475,7 @@ namespace mico {
             return res;
         }
 
-        using load_result = etool::details::result< mico::file_string,
-                                                    std::string >;
+        using load_result = source::load_result;
 
         static
         bool file_exists( const std::string &path )
@@ -1268,25 +1487,72 @@ namespace mico {
         static
         load_result load_file( const std::string &path )
         {
-            std::ifstream f(path, std::ifstream::binary);
+            return source::load( path );
+        }
+
+        /// the program of an exported file from the cache, a .micoc file
+        /// or the parser. Without 'res' the cache takes the program
+        static
+        bool load_module( const std::string &path, bool lazy,
+                          errors_list &errs, ast::program::uptr *res )
+        {
+            auto &cache( module_cache::instance( ) );
+            module_cache::stamp key;
+
+            if( module_cache::make_stamp( path, key ) ) {
+                ast::program::uptr cached;
+                switch( cache.get( key, cached ) ) {
+                case module_cache::status::HIT:
+                    if( res ) {
+                        *res = std::move(cached);
+                    }
+                    return true;
+                case module_cache::status::CYCLE:
+                    errs.emplace_back( error_open_file( path,
+                                                        "exports itself" ) );
+                    return false;
+                case module_cache::status::MISS:
+                    break;
+                }
+            }
+
+            ast::program::uptr prog;
 
-            if( !f.is_open( ) ) {
-                return load_result::fail
-                        ( std::string("Unable to open file ") + path );
+            if( !key.path.empty( ) ) {
+                auto compiled = micoc::load( micoc::path_for( path ), &key );
+                if( compiled ) {
+                    prog.reset( new ast::program( std::move(**compiled) ) );
+                }
             }
 
-            f.seekg( 0, f.end );
-            auto size = f.tellg( );
-            f.seekg( 0, f.beg );
+            bool compiled = ( prog != nullptr );
+
+            if( !prog ) {
+                auto opened = load_file( path );
+                if( !opened ) {
+                    cache.drop( key, !res );
+                    errs.emplace_back( error_open_file( path,
+                                                        opened.error( ) ) );
+                    return false;
+                }
 
-            if( !size ) {
-                return load_result::fail
-                        ( std::string("File is empty ") + path );
+                auto parsed = parse_source( *opened, lazy );
+                if( !parsed.errors( ).empty( ) ) {
+                    cache.drop( key, !res );
+                    errs.insert( errs.end( ), parsed.errors( ).begin( ),
+                                              parsed.errors( ).end( ) );
+                    return false;
+                }
+                prog.reset( new ast::program( std::move(parsed) ) );
             }
 
-            mico::file_string data( static_cast<std::size_t>( size ), '\0' );
-            f.read( &data[0], size );
-            return load_result::ok( data );
+            if( res ) {
+                cache.put( key, *prog, compiled );
+                *res = std::move(prog);
+            } else {
+                cache.keep( key, std::move(prog), compiled );
+            }
+            return true;
         }
 
         ast::statement::uptr parse_export( )
@@ -1295,40 +1561,26 @@ namespace mico {
             std::string path;
             std::string modname;
             if( current( ).ident.name == token_type::IDENT ) {
-                path = current( ).ident.literal;
+                path = current( ).ident.value( );
             } else if( current( ).ident.name == token_type::STRING ) {
-                path = current( ).ident.literal;
+                path = current( ).ident.value( );
             }
 
             if( expect_peek( token_type::TOKEN_AS, false ) ) {
                 advance( );
                 if( current( ).ident.name == token_type::IDENT ) {
-                    modname = current( ).ident.literal;
+                    modname = current( ).ident.value( );
                 } else if( current( ).ident.name == token_type::STRING ) {
-                    modname = current( ).ident.literal;
+                    modname = current( ).ident.value( );
                 }
             }
 
-            if( !file_exists( path ) ) {
-                path += ".mico";
-            }
-
-            auto opened = load_file( path );
-            if( !opened ) {
-                error_open_file( path, opened.error( ) );
+            ast::program::uptr res;
+            path = module_cache::resolve( path );
+            if( !load_module( path, lazy_, errors_, &res ) ) {
                 return nullptr;
             }
-
-            auto res = parse( *opened );
-            if( !res.errors( ).empty( ) ) {
-                errors_.insert( errors_.end( ),
-                                res.errors( ).begin( ), res.errors( ).end( ) );
-                return nullptr;
-            }
-
-            auto prog = parse( *opened );
-
-            return ast::statement::uptr( new ast::program( std::move(prog) ) );
+            return ast::statement::uptr( std::move(res) );
         }
 
         ast::statements::expr::uptr parse_expr_stmt(  )
@@ -1416,34 +1668,56 @@ namespace mico {
         static
         ast::program parse( std::string input )
         {
+            return parse( source::make( std::move(input) ) );
+        }
 
-            auto tt = mico::lexer::make(input);
+        /// 'lazy' leaves bodies of functions to be parsed when they are
+        /// needed; errors in them are found then.
+        /// Exported files are parsed ahead on several threads
+        static
+        ast::program parse( source::sptr input, bool lazy = false )
+        {
+            module_prefetch::run( input, [lazy]( const std::string &path ) {
+                errors_list errs;
+                return load_module( path, lazy, errs, nullptr );
+            } );
+            return parse_source( std::move(input), lazy );
+        }
 
+        static
+        ast::program parse_source( source::sptr input, bool lazy )
+        {
+            parser pp( token_stream( std::move(input) ) );
+            pp.lazy_ = lazy;
+
+            auto prog = pp.parse( );
+
+            /// the parser can stop before the lexer has seen the rest
+            pp.tokens_.drain( );
+
+            /// errors of the lexer are reported alone
             ast::program::error_list errors;
 
-            for( auto &e: tt.errors( ) ) {
+            for( auto &e: pp.tokens_.errors( ) ) {
                 errors.emplace_back( std::string("lexer error: ") + e );
             }
 
             if( !errors.empty( ) ) {
-                ast::program prog;
-                prog.set_errors( std::move(errors) );
-                return prog;
+                ast::program res;
+                res.set_errors( std::move(errors) );
+                return res;
             }
 
-            parser pp( std::move(tt) );
-
-            return pp.parse( );
+            return prog;
         }
 
     private:
 
-        lexer           lexer_;
-        token_iterator  cur_;
-        token_iterator  peek_;
-        nuds_map        nuds_;
-        leds_map        leds_;
+        token_stream               tokens_;
+        std::array<token_info, 2>  ring_;
+        std::size_t                cur_ = 0;
         special_map     special_;
+        bool            lazy_ = false;
 
         errors_list     errors_;
     };
@@ -5,6 +5,7 @@
 #include <iostream>
 #include "mico/parser.h"
 #include "mico/eval/tree_walking.h"
+#include "mico/eval/resolver.h"
 #include "mico/builtin.h"
 #include "mico/objects.h"
 #include "mico/state.h"
@@ -111,12 +112,18 @@ namespace mico {
 
         static
         void run( )
+        {
+            eval::tree_walking tv;
+            run( tv );
+        }
+
+        static
+        void run( eval::base &tv )
         {
             static const auto fail_type = objects::type::FAILURE;
             using namespace etool::console::ccout;
             using CE = charset::encoding;
 
-            eval::tree_walking tv;
             mico::state st;
 
             auto ev = [&tv, &st]( ast::node *n ) {
@@ -148,7 +155,8 @@ namespace mico {
 
                     if( prog.errors( ).empty( ) ) {
                         if( prog.states( ).size( ) > 0 ) {
-                            st.GC( st.env( ) );
+                            st.collect( st.env( ) );
+                            eval::resolver::process( &prog );
                             auto obj = tv.eval( &prog, st.env( ) );
                             if( obj->get_type( ) != objects::type::NULL_OBJ ) {
                                 bool failed = ( obj->get_type( ) == fail_type );
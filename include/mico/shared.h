@@ -0,0 +1,186 @@
+#ifndef MICO_SHARED_H
+#define MICO_SHARED_H
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace mico {
+
+    /// Pointers of objects and environments.
+    /// libstdc++ counts references atomically as soon as the process has
+    /// a second thread, and the parser starts threads to read exported
+    /// files. Objects and environments never leave the thread of their
+    /// state (the threads of the parser make trees only), so a build with
+    /// NONATOMIC_REFS=1 counts them with plain integers. Such a build
+    /// must not run states on several threads: the shared constants
+    /// (null, booleans, small integers) are counted by all of them.
+#if defined(NONATOMIC_REFS) && NONATOMIC_REFS && defined(__GLIBCXX__)
+
+    using ref_policy = std::integral_constant<__gnu_cxx::_Lock_policy,
+                                              __gnu_cxx::_S_single>;
+
+    template <typename T>
+    using plain_shared_ptr = std::__shared_ptr<T, ref_policy::value>;
+
+    template <typename T>
+    using weak_ptr = std::__weak_ptr<T, ref_policy::value>;
+
+    template <typename T>
+    using enable_shared_from_this =
+                std::__enable_shared_from_this<T, ref_policy::value>;
+
+    template <typename T, typename ...Args>
+    inline
+    plain_shared_ptr<T> make_plain_shared( Args && ...args )
+    {
+        return std::__make_shared<T, ref_policy::value>(
+                                        std::forward<Args>(args)... );
+    }
+
+#else
+
+    template <typename T>
+    using plain_shared_ptr = std::shared_ptr<T>;
+
+    template <typename T>
+    using weak_ptr = std::weak_ptr<T>;
+
+    template <typename T>
+    using enable_shared_from_this = std::enable_shared_from_this<T>;
+
+    template <typename T, typename ...Args>
+    inline
+    plain_shared_ptr<T> make_plain_shared( Args && ...args )
+    {
+        return std::make_shared<T>( std::forward<Args>(args)... );
+    }
+
+#endif
+
+    /// A probe for benchmarks: a build with COUNT_REFS=1 counts every
+    /// copy of these pointers, the increments of the reference counts
+    /// that a move or a borrowed reference saves. 'mico --stats' shows
+    /// the number
+#if defined(COUNT_REFS) && COUNT_REFS
+
+    struct ref_probe {
+        static
+        std::uint64_t &copies( )
+        {
+            static std::uint64_t res = 0;
+            return res;
+        }
+    };
+
+    template <typename T>
+    class counted_ptr: public plain_shared_ptr<T> {
+
+        using base_type = plain_shared_ptr<T>;
+
+        template <typename U>
+        friend class counted_ptr;
+
+        template <typename U>
+        using from = typename std::enable_if<
+                                std::is_convertible<U *, T *>::value>::type;
+
+        void count( )
+        {
+            if( this->get( ) ) {
+                ++ref_probe::copies( );
+            }
+        }
+
+    public:
+
+        counted_ptr( ) = default;
+        counted_ptr( counted_ptr && ) = default;
+        counted_ptr &operator = ( counted_ptr && ) = default;
+
+        counted_ptr( std::nullptr_t )
+        { }
+
+        template <typename U>
+        explicit
+        counted_ptr( U *ptr )
+            :base_type(ptr)
+        { }
+
+        counted_ptr( const counted_ptr &other )
+            :base_type(other)
+        {
+            count( );
+        }
+
+        template <typename U, typename = from<U> >
+        counted_ptr( const plain_shared_ptr<U> &other )
+            :base_type(other)
+        {
+            count( );
+        }
+
+        template <typename U, typename = from<U> >
+        counted_ptr( plain_shared_ptr<U> &&other )
+            :base_type(std::move(other))
+        { }
+
+        template <typename U>
+        counted_ptr( const plain_shared_ptr<U> &other, T *ptr )
+            :base_type(other, ptr)
+        {
+            count( );
+        }
+
+        template <typename U>
+        explicit
+        counted_ptr( const weak_ptr<U> &other )
+            :base_type(other)
+        {
+            count( );
+        }
+
+        counted_ptr &operator = ( const counted_ptr &other )
+        {
+            base_type::operator = ( other );
+            count( );
+            return *this;
+        }
+
+        template <typename U, typename = from<U> >
+        counted_ptr &operator = ( const plain_shared_ptr<U> &other )
+        {
+            base_type::operator = ( other );
+            count( );
+            return *this;
+        }
+
+        template <typename U, typename = from<U> >
+        counted_ptr &operator = ( plain_shared_ptr<U> &&other )
+        {
+            base_type::operator = ( std::move(other) );
+            return *this;
+        }
+    };
+
+    template <typename T>
+    using shared_ptr = counted_ptr<T>;
+
+#else
+
+    template <typename T>
+    using shared_ptr = plain_shared_ptr<T>;
+
+#endif
+
+    template <typename T, typename ...Args>
+    inline
+    shared_ptr<T> make_shared( Args && ...args )
+    {
+        return make_plain_shared<T>( std::forward<Args>(args)... );
+    }
+
+}
+
+#endif // MICO_SHARED_H
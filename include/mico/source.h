@@ -0,0 +1,154 @@
+#ifndef MICO_SOURCE_H
+#define MICO_SOURCE_H
+
+#include <string>
+#include <memory>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define MICO_SOURCE_MMAP 1
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+#include "etool/details/result.h"
+
+namespace mico {
+
+    /// Text of a script.
+    /// A file is mapped into memory where the system allows it, otherwise
+    /// it is read into a string. Tokens of the lexer point into the buffer,
+    /// so the lexer keeps the source alive while they are used.
+    class source {
+
+        struct key { };
+
+    public:
+
+        using sptr        = std::shared_ptr<source>;
+        using load_result = etool::details::result<sptr, std::string>;
+
+        source( key, std::string data )
+            :data_(std::move(data))
+            ,begin_(data_.data( ))
+            ,size_(data_.size( ))
+        { }
+
+        source( key, const char *mapped, std::size_t size )
+            :begin_(mapped)
+            ,size_(size)
+            ,mapped_(true)
+        { }
+
+        source( const source & ) = delete;
+        source &operator = ( const source & ) = delete;
+
+        ~source( )
+        {
+#if defined(MICO_SOURCE_MMAP)
+            if( mapped_ ) {
+                ::munmap( const_cast<char *>(begin_), size_ );
+            }
+#endif
+        }
+
+        static
+        sptr make( std::string data )
+        {
+            return std::make_shared<source>( key( ), std::move(data) );
+        }
+
+        static
+        load_result load( const std::string &path )
+        {
+#if defined(MICO_SOURCE_MMAP)
+            int fd = ::open( path.c_str( ), O_RDONLY );
+            if( fd < 0 ) {
+                return load_result::fail
+                        ( std::string("Unable to open file ") + path );
+            }
+
+            struct stat st;
+            if( ::fstat( fd, &st ) != 0 || !S_ISREG( st.st_mode ) ) {
+                ::close( fd );
+                return read( path );
+            }
+
+            auto size = static_cast<std::size_t>( st.st_size );
+            if( !size ) {
+                ::close( fd );
+                return load_result::fail
+                        ( std::string("File is empty ") + path );
+            }
+
+            void *map = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            ::close( fd );
+            if( map == MAP_FAILED ) {
+                return read( path );
+            }
+
+            return load_result::ok( std::make_shared<source>( key( ),
+                                    static_cast<const char *>(map), size ) );
+#else
+            return read( path );
+#endif
+        }
+
+        /// the old way; for streams that can not be mapped
+        static
+        load_result read( const std::string &path )
+        {
+            std::ifstream f(path, std::ifstream::binary);
+
+            if( !f.is_open( ) ) {
+                return load_result::fail
+                        ( std::string("Unable to open file ") + path );
+            }
+
+            f.seekg( 0, f.end );
+            auto size = f.tellg( );
+            f.seekg( 0, f.beg );
+
+            if( !size ) {
+                return load_result::fail
+                        ( std::string("File is empty ") + path );
+            }
+
+            std::string data( static_cast<std::size_t>( size ), '\0' );
+            f.read( &data[0], size );
+            return load_result::ok( make( std::move(data) ) );
+        }
+
+        const char *begin( ) const
+        {
+            return begin_;
+        }
+
+        const char *end( ) const
+        {
+            return begin_ + size_;
+        }
+
+        std::size_t size( ) const
+        {
+            return size_;
+        }
+
+        std::string str( ) const
+        {
+            return std::string( begin_, size_ );
+        }
+
+    private:
+
+        std::string  data_;
+        const char  *begin_ = nullptr;
+        std::size_t  size_  = 0;
+        bool         mapped_ = false;
+    };
+
+}
+
+#endif // MICO_SOURCE_H
@@ -2,8 +2,12 @@
 #define MICO_STATE_H
 
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
 #include "mico/objects/base.h"
 #include "mico/environment.h"
+#include "mico/collector.h"
 #include "mico/macro/processor.h"
 
 namespace mico {
@@ -13,6 +17,54 @@ namespace mico {
         using sptr          = std::shared_ptr<state>;
         using registry_type = std::map<std::uintptr_t, objects::sptr>;
 
+        struct gc_config {
+            /// new environments between two minor collections
+            std::size_t threshold   = 1024;
+            /// minor collections between two full ones
+            std::size_t major_every = 16;
+        };
+
+        /// something that holds values where the collections can not see
+        /// them, like the stacks of the bytecode machine
+        struct root_source {
+            virtual ~root_source( ) = default;
+            virtual void roots( std::vector<const objects::base *> &res )
+                                                                   const = 0;
+        };
+
+        /// values that the evaluator keeps in its locals while it computes
+        /// something else, the function of a call while its arguments are
+        /// evaluated. A closure holds its environment weakly; nothing else
+        /// would keep the environment of a temporary one
+        class temp_roots {
+        public:
+
+            explicit
+            temp_roots( state &st )
+                :st_(st)
+                ,size_(st.temps_.size( ))
+            { }
+
+            ~temp_roots( )
+            {
+                st_.temps_.resize( size_ );
+            }
+
+            temp_roots( const temp_roots & ) = delete;
+            temp_roots &operator = ( const temp_roots & ) = delete;
+
+            void add( const objects::sptr &obj )
+            {
+                if( obj && holds( obj->get_type( ) ) ) {
+                    st_.temps_.push_back( obj );
+                }
+            }
+
+        private:
+            state       &st_;
+            std::size_t  size_;
+        };
+
 #if !defined(DISABLE_MACRO) || !DISABLE_MACRO
         using macro_scope   = macro::processor::scope;
 #endif
@@ -59,13 +111,170 @@ namespace mico {
             return env_;
         }
 
+        /// a safe point; evaluators call it on every call and iteration.
+        /// It collects only when enough environments were made
         void GC( environment::sptr where )
         {
+            if( env_->young_size( ) < gc_next_ ) {
+                return;
+            }
+            /// 'where' can be held by a temporary value only
+            mark_chain( where, true );
+            auto held = pin( );
+            env_->collect_young( );
+            if( ++gc_minor_ >= gc_conf_.major_every ) {
+                gc_minor_ = 0;
+                env_->run_GC( gc_deep_ );
+                collect_cycles( where );
+            }
+            unpin( held );
+            mark_chain( where, false );
+            gc_next_ = env_->young_size( ) + gc_conf_.threshold;
+        }
+
+        /// full collection of 'where'
+        void collect( environment::sptr where )
+        {
+            auto held = pin( );
+            env_->collect_young( );
             where->run_GC( gc_deep_ );
+            collect_cycles( where );
+            unpin( held );
+            gc_next_ = env_->young_size( ) + gc_conf_.threshold;
+        }
+
+        /// drops environments that are not reachable from the global one,
+        /// the registry, 'where' and the values the evaluators hold, even
+        /// if they are marked
+        collector::result collect_cycles( environment::sptr where )
+        {
+            collector col;
+            col.add_root( where.get( ) );
+            for( auto &r: registry_ ) {
+                col.add_root( r.second.get( ) );
+            }
+            std::vector<const objects::base *> held;
+            held_values( held );
+            for( auto o: held ) {
+                col.add_root( o );
+            }
+            last_cycle_ = col.run( env_ );
+            return last_cycle_;
+        }
+
+        const collector::result &last_cycle( ) const
+        {
+            return last_cycle_;
+        }
+
+        void add_source( const root_source *src )
+        {
+            sources_.push_back( src );
+        }
+
+        void remove_source( const root_source *src )
+        {
+            sources_.erase( std::remove( sources_.begin( ), sources_.end( ),
+                                         src ),
+                            sources_.end( ) );
+        }
+
+        gc_config &gc_conf( )
+        {
+            return gc_conf_;
+        }
+
+        const gc_config &gc_conf( ) const
+        {
+            return gc_conf_;
         }
 
     private:
+
+        /// values that can keep an environment
+        static
+        bool holds( objects::type t )
+        {
+            switch( t ) {
+            case objects::type::TABLE:
+            case objects::type::ARRAY:
+            case objects::type::REFERENCE:
+            case objects::type::RETURN:
+            case objects::type::FUNCTION:
+            case objects::type::TAIL_CALL:
+            case objects::type::MODULE:
+                return true;
+            default:
+                break;
+            }
+            return false;
+        }
+
+        void held_values( std::vector<const objects::base *> &res ) const
+        {
+            for( auto &t: temps_ ) {
+                res.push_back( t.get( ) );
+            }
+            for( auto s: sources_ ) {
+                s->roots( res );
+            }
+        }
+
+        /// marks the environments of the values the evaluators hold; the
+        /// young and the full passes trust the marks only
+        std::vector<environment::sptr> pin( ) const
+        {
+            std::vector<environment::sptr> res;
+            std::vector<const objects::base *> next;
+            held_values( next );
+            if( next.empty( ) ) {
+                return res;
+            }
+            std::unordered_set<const objects::base *> seen;
+            while( !next.empty( ) ) {
+                auto o = next.back( );
+                next.pop_back( );
+                if( !o || !seen.insert( o ).second ) {
+                    continue;
+                }
+                if( auto e = o->hold( ) ) {
+                    auto env = const_cast<environment *>( e )
+                                                      ->shared_from_this( );
+                    mark_chain( env, true );
+                    res.emplace_back( std::move(env) );
+                }
+                o->trace( next );
+            }
+            return res;
+        }
+
+        static
+        void unpin( const std::vector<environment::sptr> &envs )
+        {
+            for( auto &e: envs ) {
+                mark_chain( e, false );
+            }
+        }
+
+        static
+        void mark_chain( environment::sptr env, bool mark )
+        {
+            for( ; env; env = env->parent( ) ) {
+                if( mark ) {
+                    env->mark( );
+                } else {
+                    env->unmark( );
+                }
+            }
+        }
+
         bool              gc_deep_ = true;
+        gc_config         gc_conf_;
+        std::size_t       gc_next_ = gc_config( ).threshold;
+        std::size_t       gc_minor_ = 0;
+        collector::result last_cycle_;
+        std::vector<objects::sptr>       temps_;
+        std::vector<const root_source *> sources_;
         environment::sptr env_;
         registry_type     registry_;
 
@@ -0,0 +1,155 @@
+#ifndef MICO_TOKEN_NAMES_H
+#define MICO_TOKEN_NAMES_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "mico/tokens.h"
+#include "mico/idents.h"
+
+namespace mico {
+
+    /// name -> tokens::type for the visible tokens.
+    /// 'words' are keywords, 'symbols' are operators and the marks that
+    /// start strings, comments and lines. Every table is a perfect hash:
+    /// the seed is chosen when the table is built so that the names get
+    /// different cells, a lookup is one hash and one compare.
+    class token_names {
+
+        struct entry {
+            const char   *name = nullptr;
+            std::size_t   size = 0;
+            tokens::type  tt   = tokens::type::NONE;
+        };
+
+    public:
+
+        static
+        const token_names &words( )
+        {
+            static const token_names res( true );
+            return res;
+        }
+
+        static
+        const token_names &symbols( )
+        {
+            static const token_names res( false );
+            return res;
+        }
+
+        tokens::type find( const char *name, std::size_t size ) const
+        {
+            auto &e( table_[hash( name, size, seed_ ) & mask_] );
+            if( e.size == size && std::memcmp( e.name, name, size ) == 0 ) {
+                return e.tt;
+            }
+            return tokens::type::NONE;
+        }
+
+        /// the longest name at the beginning of [begin, end)
+        tokens::type match( const char *begin, const char *end,
+                            const char **found ) const
+        {
+            auto len = static_cast<std::size_t>( end - begin );
+            for( len = len < longest_ ? len : longest_; len > 0; --len ) {
+                auto tt = find( begin, len );
+                if( tt != tokens::type::NONE ) {
+                    *found = begin + len;
+                    return tt;
+                }
+            }
+            return tokens::type::NONE;
+        }
+
+    private:
+
+        static
+        std::uint32_t hash( const char *name, std::size_t size,
+                            std::uint32_t seed )
+        {
+            std::uint32_t res = seed;
+            for( std::size_t i = 0; i < size; ++i ) {
+                res ^= static_cast<std::uint8_t>( name[i] );
+                res *= 16777619u;
+            }
+            return res ^ ( res >> 15 );
+        }
+
+        void add( const char *name, tokens::type tt )
+        {
+            entry e;
+            e.name = name;
+            e.size = std::strlen( name );
+            e.tt   = tt;
+            names_.push_back( e );
+            longest_ = e.size > longest_ ? e.size : longest_;
+        }
+
+        bool place( std::size_t size, std::uint32_t seed )
+        {
+            table_.assign( size, entry( ) );
+            for( auto &n: names_ ) {
+                auto &cell( table_[hash( n.name, n.size, seed ) & (size - 1)] );
+                if( cell.name ) {
+                    return false;
+                }
+                cell = n;
+            }
+            seed_ = seed;
+            mask_ = size - 1;
+            return true;
+        }
+
+        explicit
+        token_names( bool words )
+        {
+            using TT = tokens::type;
+            auto first = static_cast<int>(TT::FIRST_VISIBLE) + 1;
+            auto last  = static_cast<int>(TT::LAST_VISIBLE);
+
+            for( auto i = first; i != last; ++i ) {
+                auto tt   = static_cast<TT>(i);
+                auto name = tokens::name::get( tt );
+                if( idents::is_ident( name[0] ) == words ) {
+                    add( name, tt );
+                }
+            }
+
+            if( words ) {
+                add( "λ",    TT::FUNCTION );
+            } else {
+                add( "\"",   TT::STRING );
+                add( "'",    TT::CHARACTER );
+                add( "\n",   TT::END_OF_LINE );
+                add( "\r\n", TT::END_OF_LINE );
+                add( "\n\r", TT::END_OF_LINE );
+                add( "//",   TT::COMMENT );
+                add( "←",    TT::LARROW );
+                add( "→",    TT::RARROW );
+            }
+
+            std::size_t size = 16;
+            while( size < names_.size( ) * 2 ) {
+                size *= 2;
+            }
+
+            std::uint32_t seed = 2166136261u;
+            while( !place( size, seed ) ) {
+                if( ++seed % 4096 == 0 ) {
+                    size *= 2;
+                }
+            }
+        }
+
+        std::vector<entry> names_;
+        std::vector<entry> table_;
+        std::uint32_t      seed_    = 0;
+        std::size_t        mask_    = 0;
+        std::size_t        longest_ = 0;
+    };
+
+}
+
+#endif // MICO_TOKEN_NAMES_H
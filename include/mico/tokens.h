@@ -204,13 +204,53 @@ namespace mico { namespace tokens {
         }
     };
 
+    /// characters of a token.
+    /// A view points into the source buffer, into a name of the token
+    /// type or into a string that the lexer keeps (decoded literals).
+    struct view {
+
+        view( ) = default;
+
+        view( const char *b, std::size_t len )
+            :ptr(b)
+            ,size(len)
+        { }
+
+        explicit
+        view( const char *str )
+            :ptr(str)
+            ,size(std::char_traits<char>::length( str ))
+        { }
+
+        const char *begin( ) const
+        {
+            return ptr;
+        }
+
+        const char *end( ) const
+        {
+            return ptr + size;
+        }
+
+        bool empty( ) const
+        {
+            return size == 0;
+        }
+
+        std::string str( ) const
+        {
+            return std::string( ptr, size );
+        }
+
+        const char  *ptr  = "";
+        std::size_t  size = 0;
+    };
+
     struct type_ident {
 
-        using value_type = std::string;
+        using value_type = view;
 
         type_ident( ) = default;
-        type_ident( const type_ident & ) = default;
-        type_ident& operator = ( const type_ident & ) = default;
 
         explicit
         type_ident( type tt )
@@ -218,24 +258,18 @@ namespace mico { namespace tokens {
             ,literal(name::get(tt))
         { }
 
-        type_ident( type tt, const std::string &val )
+        type_ident( type tt, view val )
             :name(tt)
             ,literal(val)
         { }
 
-        type_ident( type_ident &&other )
-            :name(other.name)
-            ,literal(std::move(other.literal))
-        { }
-
-        type_ident& operator = ( type_ident &&other )
+        /// a string that the caller owns
+        std::string value( ) const
         {
-            name     = other.name;
-            literal = std::move(other.literal);
-            return *this;
+            return literal.str( );
         }
 
-        type        name;
+        type        name = type::NONE;
         value_type  literal;
     };
 
@@ -251,35 +285,21 @@ namespace mico { namespace tokens {
 
     struct info {
 
-        using value_type = std::string;
-
         info( ) = default;
-        info( const info & ) = default;
-        info& operator = ( const info & ) = default;
 
         explicit
         info( type t )
             :ident(t)
         { }
 
-        info( type t, const std::string &value )
-            :ident(t, std::move(value))
-        { }
-
-        info( info &&other )
-            :where(other.where)
-            ,ident(std::move(other.ident))
+        info( type t, view value )
+            :ident(t, value)
         { }
 
-        info& operator = ( info &&other )
-        {
-            where = other.where;
-            ident = std::move(other.ident);
-            return *this;
-        }
-
         position where;
         type_ident ident;
+        /// where the token starts in the source
+        const char *begin = nullptr;
     };
 
     inline
@@ -294,6 +314,12 @@ namespace mico { namespace tokens {
         return o << tt.line << ":" << tt.pos;
     }
 
+    inline
+    std::ostream &operator << (std::ostream &o, const tokens::view &v )
+    {
+        return o.write( v.ptr, static_cast<std::streamsize>(v.size) );
+    }
+
     inline
     std::ostream &operator << (std::ostream &o, const tokens::type_ident &ti )
     {
@@ -6,45 +6,63 @@
 
 #include "mico/objects.h"
 #include "mico/parser.h"
+#include "mico/micoc.h"
 #include "mico/eval/tree_walking.h"
+#include "mico/eval/vm.h"
+#include "mico/eval/resolver.h"
+#include "mico/eval/folder.h"
 #include "mico/repl.h"
 #include "mico/charset/encoding.h"
 
 #include <stdio.h>
 #include <thread>
+#include <chrono>
 
 #include "etool/details/result.h"
 
-int run_repl( )
+int run_repl( mico::eval::base &tv )
 {
-    mico::repl::run( );
+    mico::repl::run( tv );
 
     return 0;
 }
 
 using namespace mico;
 
-int run_file( std::string path )
-{
-    std::ifstream f(path, std::ifstream::binary);
-    if( !f.is_open( ) ) {
-        std::cerr << "Unable to open file " << path << "\n";
-        return 1;
-    }
+struct run_options {
+    bool lazy     = false;
+    bool fold     = false;
+    bool inlining = false;
+    bool stats    = false;
+};
 
-    f.seekg( 0, f.end );
-    auto size = f.tellg( );
-    f.seekg( 0, f.beg );
+int run_program( ast::program &prog, eval::base &tv, mico::state &st );
 
-    if( !size ) {
-        std::cerr << "file is empty " << path << "\n";
-        return 2;
+void fold_program( ast::program &prog, const run_options &opts )
+{
+    if( !opts.fold || !prog.errors( ).empty( ) ) {
+        return;
+    }
+    auto rep = eval::folder::process( &prog, opts.inlining );
+    if( opts.stats ) {
+        std::cerr << "fold: " << rep.nodes_before << " -> "
+                  << rep.nodes_after << " nodes, "
+                  << rep.folded << " folded, "
+                  << rep.pruned << " branches pruned, "
+                  << rep.calls << " calls, "
+                  << rep.inlined << " inlined, "
+                  << rep.seconds * 1000 << " ms\n";
     }
+}
 
-    mico::file_string data( size, '\0' );
-    f.read( &data[0], size );
+int run_file( std::string path, eval::base &tv, const run_options &opts )
+{
+    auto data = source::load( path );
+    if( !data ) {
+        std::cerr << data.error( ) << "\n";
+        return parser::file_exists( path ) ? 2 : 1;
+    }
 
-    eval::tree_walking tv;
     mico::state st;
 
     auto ev = [&tv, &st]( ast::node *n ) {
@@ -52,15 +70,33 @@ int run_file( std::string path )
     };
 
     all::init( st, ev );
-    auto prog = parser::parse( data );
+
+    if( micoc::is_compiled( (*data)->begin( ), (*data)->end( ) ) ) {
+        auto loaded = micoc::decode( (*data)->begin( ), (*data)->end( ) );
+        if( !loaded ) {
+            std::cerr << path << ": " << loaded.error( ) << "\n";
+            return 2;
+        }
+        fold_program( **loaded, opts );
+        return run_program( **loaded, tv, st );
+    }
+
+    auto prog = parser::parse( *data, opts.lazy );
 
     if( prog.errors( ).empty( ) ) {
         macro::processor::process( &st.macros( ), &prog,
                                    prog.errors( ), ev );
     }
+    fold_program( prog, opts );
 
+    return run_program( prog, tv, st );
+}
+
+int run_program( ast::program &prog, eval::base &tv, mico::state &st )
+{
     if( prog.errors( ).empty( ) ) {
 
+        eval::resolver::process( &prog );
         auto obj = tv.eval( &prog, st.env( ) );
 
         if( obj->get_type( ) == objects::type::INTEGER ) {
@@ -79,16 +115,198 @@ int run_file( std::string path )
     return 0;
 }
 
+/// parses the file, expands macros and stores the program
+int run_compile( std::string path, std::string out, eval::base &tv,
+                 const run_options &opts )
+{
+    auto data = source::load( path );
+    if( !data ) {
+        std::cerr << data.error( ) << "\n";
+        return 1;
+    }
+
+    module_cache::stamp key;
+    module_cache::make_stamp( path, key );
+
+    mico::state st;
+
+    auto ev = [&tv, &st]( ast::node *n ) {
+        return tv.eval( n, st.env( ) );
+    };
+
+    all::init( st, ev );
+    auto prog = parser::parse( *data );
+    auto macros = micoc::defines_macros( &prog );
+
+    if( prog.errors( ).empty( ) ) {
+        macro::processor::process( &st.macros( ), &prog,
+                                   prog.errors( ), ev );
+    }
+    fold_program( prog, opts );
+
+    if( !prog.errors( ).empty( ) ) {
+        for( auto &e: prog.errors( ) ) {
+            std::cerr << e << "\n";
+        }
+        return 1;
+    }
+
+    auto err = micoc::save( &prog, out, key, macros );
+    if( !err.empty( ) ) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/// lexer throughput: tokenizes the file for about a second
+int run_lex( std::string path )
+{
+    auto data = source::load( path );
+    if( !data ) {
+        std::cerr << data.error( ) << "\n";
+        return 1;
+    }
+
+    using clock = std::chrono::steady_clock;
+    std::size_t passes = 0;
+    std::size_t tokens = 0;
+    auto start = clock::now( );
+    std::chrono::duration<double> spent(0);
+
+    while( spent.count( ) < 1.0 ) {
+        lexer::stream lex( *data );
+        tokens = 1;
+        while( lex.next( ).ident.name != tokens::type::END_OF_FILE ) {
+            ++tokens;
+        }
+        ++passes;
+        spent = clock::now( ) - start;
+    }
+
+    auto mb = static_cast<double>((*data)->size( ) * passes) / (1024 * 1024);
+    std::cout << path << ": " << (*data)->size( ) << " bytes, "
+              << tokens << " tokens, " << passes << " passes, "
+              << mb / spent.count( ) << " MB/s\n";
+    return 0;
+}
+
+/// parser throughput: parses the file for about a second, runs nothing
+int run_parse( std::string path, bool lazy )
+{
+    auto data = source::load( path );
+    if( !data ) {
+        std::cerr << data.error( ) << "\n";
+        return 1;
+    }
+
+    using clock = std::chrono::steady_clock;
+    std::size_t passes = 0;
+    auto start = clock::now( );
+    std::chrono::duration<double> spent(0);
+
+    while( spent.count( ) < 1.0 ) {
+        auto prog = parser::parse( *data, lazy );
+        if( !prog.errors( ).empty( ) ) {
+            for( auto &e: prog.errors( ) ) {
+                std::cerr << e << "\n";
+            }
+            return 1;
+        }
+        ++passes;
+        spent = clock::now( ) - start;
+    }
+
+    std::size_t lines = 0;
+    for( auto c: **data ) {
+        lines += ( c == '\n' ) ? 1 : 0;
+    }
+
+    auto mb = static_cast<double>((*data)->size( ) * passes) / (1024 * 1024);
+    auto ls = static_cast<double>(lines * passes);
+    std::cout << path << ": " << (*data)->size( ) << " bytes, "
+              << lines << " lines, " << passes << " passes, "
+              << mb / spent.count( ) << " MB/s, "
+              << ls / spent.count( ) << " lines/s\n";
+    return 0;
+}
+
+void print_stats( )
+{
+    auto &cache( module_cache::instance( ) );
+    std::cerr << "modules: " << cache.misses( ) - cache.compiled( )
+              << " parsed, " << cache.compiled( ) << " compiled, "
+              << cache.hits( ) << " reused\n";
+#if defined(COUNT_REFS) && COUNT_REFS
+    std::cerr << "refs: " << ref_probe::copies( ) << " pointer copies\n";
+#endif
+}
+
 int main_lex( );
 
 int main( int argc, char * argv[ ]  )
 {
     try {
+        /// '--vm' switches to the bytecode engine
+        /// '--stats' shows how the exported modules were loaded and,
+        ///          in a COUNT_REFS=1 build, the copies of pointers
+        /// '--lazy' parses bodies of functions when they are called
+        /// '--fold' folds constants and drops dead branches before the
+        ///          run; '--stats' shows what it did
+        /// '--inline' folds and puts small functions in place of their
+        ///            calls
+        bool use_vm = false;
+        run_options opts;
+        while( argc > 1 ) {
+            std::string opt( argv[1] );
+            if( opt == "--vm" ) {
+                use_vm = true;
+            } else if( opt == "--stats" ) {
+                opts.stats = true;
+            } else if( opt == "--lazy" ) {
+                opts.lazy = true;
+            } else if( opt == "--fold" ) {
+                opts.fold = true;
+            } else if( opt == "--inline" ) {
+                opts.fold     = true;
+                opts.inlining = true;
+            } else {
+                break;
+            }
+            --argc;
+            ++argv;
+        }
+
+        /// '--lex' measures the lexer only
+        if( ( argc > 2 ) && ( std::string( argv[1] ) == "--lex" ) ) {
+            return run_lex( argv[2] );
+        }
+
+        /// '--parse' measures the lexer and the parser
+        if( ( argc > 2 ) && ( std::string( argv[1] ) == "--parse" ) ) {
+            return run_parse( argv[2], opts.lazy );
+        }
+
+        eval::tree_walking tw;
+        eval::vm bc;
+        eval::base &tv( use_vm ? static_cast<eval::base &>(bc) : tw );
+
+        /// '--compile file [out]' writes file.micoc
+        if( ( argc > 2 ) && ( std::string( argv[1] ) == "--compile" ) ) {
+            std::string out = ( argc > 3 ) ? argv[3]
+                                           : micoc::path_for( argv[2] );
+            return run_compile( argv[2], out, tv, opts );
+        }
+
         if( argc > 1 ) {
-            return run_file( argv[1] );
+            auto res = run_file( argv[1], tv, opts );
+            if( opts.stats ) {
+                print_stats( );
+            }
+            return res;
         } else {
             mico::charset::encoding::init_console( );
-            return run_repl( );
+            return run_repl( tv );
         }
     } catch ( const std::exception &ex ) {
         std::cerr << "Something wrong: " << ex.what( ) << "\n";
@@ -13,8 +13,19 @@ DISTFILES += \
     drafts/tail_recursion.md \
     tests.txt \
     README2.md \
+    examples/gc.mico \
+    examples/lazy.mico \
+    examples/lazy_errors.mico \
     examples/t002.mico \
     examples/t001.mico \
+    examples/bench/operators.mico \
+    examples/bench/closures.mico \
+    examples/bench/lexer.mico \
+    examples/bench/parser.mico \
+    examples/bench/strings.mico \
+    examples/bench/folding.mico \
+    examples/bench/pure_calls.mico \
+    examples/bench/inlining.mico \
     README.md
 
 
@@ -23,6 +34,13 @@ DISTFILES += \
 DEFINES += CHECK_CASTS=1
 DEFINES += DISABLE_SWITCH_WARNINGS=1
 DEFINES += DISABLE_MACRO=0
+# a state runs on one thread; see include/mico/shared.h
+DEFINES += NONATOMIC_REFS=1
+# 'mico --stats' counts copies of object pointers; see include/mico/shared.h
+#DEFINES += COUNT_REFS=1
+
+# exported files are parsed on several threads
+unix: LIBS += -pthread
 
 #CONFIG += c++14
 
@@ -47,6 +65,7 @@ HEADERS += \
     etool/include/etool/trees/trie/nodes/map.h \
     etool/include/etool/trees/trie/base.h \
     include/mico/builtin/common.h \
+    include/mico/eval/operations/binary.h \
     include/mico/eval/operations/arrays.h \
     include/mico/eval/operations/boolean.h \
     include/mico/eval/operations/common.h \
@@ -59,6 +78,12 @@ HEADERS += \
     include/mico/eval/evaluator.h \
     include/mico/eval/operation.h \
     include/mico/eval/tree_walking.h \
+    include/mico/eval/bytecode.h \
+    include/mico/eval/vm.h \
+    include/mico/eval/resolver.h \
+    include/mico/eval/folder.h \
+    include/mico/layout.h \
+    include/mico/collector.h \
     include/mico/expressions/array.h \
     include/mico/expressions/call.h \
     include/mico/expressions/elipsis.h \
@@ -100,12 +125,19 @@ HEADERS += \
     include/mico/objects/string.h \
     include/mico/objects/table.h \
     include/mico/ast.h \
+    include/mico/node_pool.h \
+    include/mico/source.h \
+    include/mico/token_names.h \
+    include/mico/module_cache.h \
+    include/mico/micoc.h \
+    include/mico/module_prefetch.h \
     include/mico/builtin.h \
     include/mico/environment.h \
     include/mico/expressions.h \
     include/mico/idents.h \
     include/mico/lexer.h \
     include/mico/numeric.h \
+    include/mico/shared.h \
     include/mico/objects.h \
     include/mico/operations.h \
     include/mico/parser.h \
@@ -129,6 +161,7 @@ HEADERS += \
     include/mico/eval/operations/infinite.h \
     include/mico/expressions/mut.h \
     include/mico/expressions/mutablity.h \
+    include/mico/expressions/lazy.h \
     include/mico/objects/rstring.h \
     include/mico/eval/operations/rstring.h \
     include/mico/eval/operations/character.h \